@@ -0,0 +1,284 @@
+/*
+ * Shared I2C bus for several drivers on the same Wire pins
+ *
+ * Requires the Wire library, and TransportIrq.h from the Transport library.
+ *
+ * 2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+ */
+
+#include "Wire.h"
+#include <TransportIrq.h>
+#include "I2CBus.h"
+
+I2CBus_class I2CBus;
+
+typedef struct {
+    uint8_t priority;
+    uint16_t max_hold_us;
+    I2CBusStats stats;
+} I2CBus_client;
+
+typedef struct {
+    volatile uint8_t used;
+    uint8_t client;
+    uint8_t address;
+    uint8_t len;
+    uint8_t data[I2CBUS_QUEUE_BYTES];
+    uint8_t seq;
+    unsigned long posted_at;
+} I2CBus_posted;
+
+static unsigned char I2CBus_initialized=0;
+static uint16_t I2CBus_byte_us=90;      // time for one byte (9 clocks) on the bus
+static uint8_t I2CBus_nclients=0;
+static I2CBus_client I2CBus_clients[I2CBUS_MAX_CLIENTS];
+static I2CBus_posted I2CBus_queue[I2CBUS_QUEUE_SIZE];
+static uint8_t I2CBus_seq=0;
+static I2CBusStats I2CBus_no_stats;
+
+
+/* Interrupts off, saving the previous state (so post() can be called from a handler, on AVR and ARM) */
+#define I2CBUS_LOCK()       uint8_t _irq = transport_irq_off()
+#define I2CBUS_UNLOCK()     transport_irq_restore( _irq )
+
+
+static void I2CBus_clear( I2CBusStats *st )
+{
+    memset( st, 0, sizeof(I2CBusStats) );
+    latency_reset( &st->latency );
+}
+
+/* Would this many bytes on the bus fit within the client's cap? */
+static bool I2CBus_fits( I2CBus_client *c, uint8_t nbytes )
+{
+    return ( c->max_hold_us==0 || (unsigned long)nbytes * I2CBus_byte_us <= c->max_hold_us );
+}
+
+/* Record a finished transaction */
+static uint8_t I2CBus_done( I2CBus_client *c, unsigned long submitted_at, unsigned long started_at, uint8_t status )
+{
+    unsigned long now = micros();
+    
+    if( c->max_hold_us && (now - started_at) > c->max_hold_us )
+        c->stats.overruns++;
+    if( status != I2CBUS_OK )
+        c->stats.errors++;
+    
+    c->stats.transactions++;
+    latency_record( &c->stats.latency, now - submitted_at );
+    
+    return status;
+}
+
+static uint8_t I2CBus_write( uint8_t client, uint8_t address, const uint8_t *data, uint8_t len, unsigned long submitted_at )
+{
+    I2CBus_client *c = &I2CBus_clients[client];
+    unsigned long started_at;
+    uint8_t status;
+    
+    if( !I2CBus_fits( c, len+1 ) )
+    {
+        c->stats.refused++;
+        return I2CBUS_TOO_LONG;
+    }
+    
+    started_at = micros();
+    Wire.beginTransmission( address );
+    Wire.write( data, len );
+    status = ( Wire.endTransmission()==0 ) ? I2CBUS_OK : I2CBUS_NACK;
+    
+    return I2CBus_done( c, submitted_at, started_at, status );
+}
+
+/* Run the posted writes from clients of at least this priority, most important (then oldest) first */
+static void I2CBus_drain( uint8_t min_priority )
+{
+    uint8_t i, best;
+    I2CBus_posted p;
+    
+    for(;;)
+    {
+        best = I2CBUS_QUEUE_SIZE;
+        for( i=0; i<I2CBUS_QUEUE_SIZE; i++ )
+        {
+            if( !I2CBus_queue[i].used )
+                continue;
+            uint8_t prio = I2CBus_clients[I2CBus_queue[i].client].priority;
+            if( prio < min_priority )
+                continue;
+            if( best==I2CBUS_QUEUE_SIZE
+             || prio > I2CBus_clients[I2CBus_queue[best].client].priority
+             || ( prio==I2CBus_clients[I2CBus_queue[best].client].priority
+                  && (uint8_t)(I2CBus_queue[i].seq - I2CBus_queue[best].seq) > 0x7F ) )
+                best = i;
+        }
+        if( best==I2CBUS_QUEUE_SIZE )
+            return;
+        
+        {
+            I2CBUS_LOCK();
+            p = I2CBus_queue[best];
+            I2CBus_queue[best].used = 0;
+            I2CBUS_UNLOCK();
+        }
+        I2CBus_write( p.client, p.address, p.data, p.len, p.posted_at );
+    }
+}
+
+
+/*
+ * @brief Initialize the bus.  Only the first call does anything.
+ * @param[in]   clock_hz    Bus clock.  AVR only: other cores stay at Wire's default 100kHz, and the transaction
+ *                          time estimates are for that.
+ * @return none.
+ */
+void I2CBus_class::begin( uint32_t clock_hz )
+{
+    if( I2CBus_initialized )
+        return;
+    I2CBus_initialized = 1;
+    
+    Wire.begin();
+#ifdef TWBR
+    TWBR = ((F_CPU / clock_hz) - 16) / 2;
+#else
+    clock_hz = I2CBUS_CLOCK_DEFAULT;    // not set here, so estimate for the rate Wire is actually using
+#endif
+    I2CBus_byte_us = (9000000UL + clock_hz - 1) / clock_hz;
+}
+
+/*
+ * @brief Register a client (a driver) of the bus.
+ * @param[in]   priority        I2CBUS_PRIORITY_xxx.  Posted writes go before any transaction of the same or lower priority.
+ * @param[in]   max_hold_us     Longest time one transaction may hold the bus, or 0 for no limit.
+ * @return the client number, or I2CBUS_NO_CLIENT if there are too many.
+ */
+uint8_t I2CBus_class::addClient( uint8_t priority, uint16_t max_hold_us )
+{
+    if( I2CBus_nclients >= I2CBUS_MAX_CLIENTS )
+        return I2CBUS_NO_CLIENT;
+    I2CBus_clients[I2CBus_nclients].priority = priority;
+    I2CBus_clients[I2CBus_nclients].max_hold_us = max_hold_us;
+    I2CBus_clear( &I2CBus_clients[I2CBus_nclients].stats );
+    return I2CBus_nclients++;
+}
+
+/*
+ * @brief Write bytes to a device, after any posted writes of the same or higher priority.
+ *        (Including this client's own, so a device sees one client's writes in order.)
+ * @return I2CBUS_xxx status.
+ */
+uint8_t I2CBus_class::write( uint8_t client, uint8_t address, const uint8_t *data, uint8_t len )
+{
+    unsigned long submitted_at = micros();
+    
+    if( client >= I2CBus_nclients )
+        return I2CBUS_BAD_CLIENT;
+    I2CBus_drain( I2CBus_clients[client].priority );
+    return I2CBus_write( client, address, data, len, submitted_at );
+}
+
+/*
+ * @brief Read bytes from a device, after any posted writes of the same or higher priority.
+ * @return I2CBUS_xxx status.  On I2CBUS_SHORT the contents of data are undefined.
+ */
+uint8_t I2CBus_class::read( uint8_t client, uint8_t address, uint8_t *data, uint8_t len )
+{
+    unsigned long submitted_at = micros();
+    unsigned long started_at;
+    I2CBus_client *c;
+    uint8_t n = 0;
+    
+    if( client >= I2CBus_nclients )
+        return I2CBUS_BAD_CLIENT;
+    c = &I2CBus_clients[client];
+    I2CBus_drain( c->priority );
+    
+    if( !I2CBus_fits( c, len+1 ) )
+    {
+        c->stats.refused++;
+        return I2CBUS_TOO_LONG;
+    }
+    
+    started_at = micros();
+    Wire.requestFrom( address, len );
+    while( Wire.available() )
+    {
+        uint8_t b = (uint8_t)Wire.read();
+        if( n < len )
+            data[n++] = b;
+    }
+    
+    return I2CBus_done( c, submitted_at, started_at, ( n==len ) ? I2CBUS_OK : I2CBUS_SHORT );
+}
+
+/*
+ * @brief Queue a short write, to run on the next service() or before the next transaction of the same or lower priority.
+ * @param[in]   len     Up to I2CBUS_QUEUE_BYTES.
+ * @return I2CBUS_OK, or I2CBUS_NO_ROOM.
+ */
+uint8_t I2CBus_class::post( uint8_t client, uint8_t address, const uint8_t *data, uint8_t len )
+{
+    uint8_t i, status = I2CBUS_NO_ROOM;
+    
+    if( client >= I2CBus_nclients )
+        return I2CBUS_BAD_CLIENT;
+    if( len > I2CBUS_QUEUE_BYTES )
+        return I2CBUS_NO_ROOM;
+    
+    I2CBUS_LOCK();
+    for( i=0; i<I2CBUS_QUEUE_SIZE; i++ )
+    {
+        if( !I2CBus_queue[i].used )
+        {
+            I2CBus_queue[i].client = client;
+            I2CBus_queue[i].address = address;
+            I2CBus_queue[i].len = len;
+            memcpy( I2CBus_queue[i].data, data, len );
+            I2CBus_queue[i].seq = I2CBus_seq++;
+            I2CBus_queue[i].posted_at = micros();
+            I2CBus_queue[i].used = 1;
+            status = I2CBUS_OK;
+            break;
+        }
+    }
+    I2CBUS_UNLOCK();
+    return status;
+}
+
+/*
+ * @brief Run all posted writes.  Call this from your loop().
+ * @return none.
+ */
+void I2CBus_class::service()
+{
+    I2CBus_drain( 0 );
+}
+
+/*
+ * @brief Statistics for one client.
+ */
+const I2CBusStats& I2CBus_class::getStats( uint8_t client )
+{
+    if( client >= I2CBus_nclients )
+        return I2CBus_no_stats;
+    return I2CBus_clients[client].stats;
+}
+
+/*
+ * @brief Average latency for one client, in microseconds.
+ */
+uint16_t I2CBus_class::getLatencyAvg( uint8_t client )
+{
+    return latency_avg( &getStats( client ).latency );
+}
+
+/*
+ * @brief Clear the statistics for one client.
+ * @return none.
+ */
+void I2CBus_class::resetStats( uint8_t client )
+{
+    if( client < I2CBus_nclients )
+        I2CBus_clear( &I2CBus_clients[client].stats );
+}
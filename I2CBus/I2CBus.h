@@ -0,0 +1,66 @@
+/*
+ * Shared I2C bus for several drivers on the same Wire pins
+ *
+ * Drivers (clients) register with a priority and a cap on how long one transaction may hold the bus.
+ * The bus is configured once, by whichever driver calls begin() first.
+ *
+ * Transactions:
+ *      write() and read() run immediately, but any posted writes from clients of the same or higher priority
+ *          go first.  So one client's posted and direct writes reach the device in order.
+ *      post() queues a short write (e.g. a codec volume change); it is safe from an interrupt handler (AVR and ARM).
+ *          Posted writes run on the next service(), or before the next transaction of the same or lower priority.
+ *      A transaction that is estimated to take longer than the client's cap is refused (I2CBUS_TOO_LONG).
+ *      Wire can't be interrupted once started, so a transaction that takes longer than estimated is only counted.
+ *
+ * Each client has statistics: counts, and min/avg/max latency from submit (or post) to completion.
+ *
+ * The clock rate passed to begin() is set on AVR only; other cores (e.g. Teensy 3.x) run at Wire's default 100kHz.
+ *
+ * Requires the Wire library, and the Transport library for TransportIrq.h.
+ * Your sketch should #include <Wire.h> and <I2CBus.h>.
+ *
+ * 2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+ */
+
+#ifndef __I2CBUS_H__
+#define __I2CBUS_H__
+
+#include "Arduino.h"
+#include "I2CBusStatus.h"       // priorities and return codes
+#include "LatencyStats.h"
+
+#define I2CBUS_MAX_CLIENTS      4
+#define I2CBUS_QUEUE_SIZE       8       // posted writes waiting
+#define I2CBUS_QUEUE_BYTES      2       // payload of one posted write (not counting the address)
+#define I2CBUS_CLOCK_DEFAULT    100000
+
+
+/* Per-client statistics */
+typedef struct {
+    uint32_t transactions;
+    uint16_t errors;            // short reads and NACKs
+    uint16_t refused;           // estimated longer than the cap
+    uint16_t overruns;          // actually held the bus longer than the cap
+    LatencyStats latency;       // submit (or post) to completion
+} I2CBusStats;
+
+
+class I2CBus_class
+{
+public:
+    static void begin( uint32_t clock_hz = I2CBUS_CLOCK_DEFAULT );
+    static uint8_t addClient( uint8_t priority, uint16_t max_hold_us );
+    
+    static uint8_t write( uint8_t client, uint8_t address, const uint8_t *data, uint8_t len );
+    static uint8_t read( uint8_t client, uint8_t address, uint8_t *data, uint8_t len );
+    static uint8_t post( uint8_t client, uint8_t address, const uint8_t *data, uint8_t len );
+    static void service();
+    
+    static const I2CBusStats& getStats( uint8_t client );
+    static uint16_t getLatencyAvg( uint8_t client );
+    static void resetStats( uint8_t client );
+};
+
+extern I2CBus_class I2CBus;
+
+#endif
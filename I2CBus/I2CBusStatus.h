@@ -0,0 +1,27 @@
+/*
+ * I2CBus priorities and return codes
+ *
+ * Kept apart from I2CBus.h so code that only needs the codes (e.g. the mock transports) doesn't pull in
+ * Arduino.h or Wire.
+ *
+ * 2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+ */
+
+#ifndef __I2CBUSSTATUS_H__
+#define __I2CBUSSTATUS_H__
+
+#define I2CBUS_PRIORITY_LOW     0
+#define I2CBUS_PRIORITY_NORMAL  1
+#define I2CBUS_PRIORITY_HIGH    2
+
+#define I2CBUS_NO_CLIENT        0xFF    // returned from addClient() when there's no room
+
+/* Return codes */
+#define I2CBUS_OK               0
+#define I2CBUS_SHORT            1       // read: fewer bytes arrived than requested
+#define I2CBUS_NACK             2       // write: not acknowledged
+#define I2CBUS_TOO_LONG         3       // would hold the bus longer than the client's cap; not done
+#define I2CBUS_NO_ROOM          4       // post: queue full, or too many bytes
+#define I2CBUS_BAD_CLIENT       5
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ * Latency statistics: min, max and a running average, in microseconds
+ *
+ * Shared by I2CBus, Nunchuk and NunchukDAC.  No Arduino core needed.
+ *
+ * 2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+ */
+
+#ifndef __LATENCYSTATS_H__
+#define __LATENCYSTATS_H__
+
+#include <stdint.h>
+
+typedef struct {
+    uint16_t min_us;
+    uint16_t max_us;
+    uint32_t sum_us;        // sum_us / count is the average, or use latency_avg()
+    uint32_t count;         // both are halved before sum_us can overflow, so the average keeps running
+} LatencyStats;
+
+
+static inline void latency_reset( LatencyStats *l )
+{
+    l->min_us = 0xFFFF;
+    l->max_us = 0;
+    l->sum_us = 0;
+    l->count = 0;
+}
+
+/* Add one measurement; anything over 0xFFFF counts as 0xFFFF */
+static inline void latency_record( LatencyStats *l, unsigned long t )
+{
+    if( t > 0xFFFF )
+        t = 0xFFFF;
+    if( l->sum_us > 0xFFFFFFFFUL - 0xFFFF )
+    {
+        l->sum_us >>= 1;
+        l->count >>= 1;
+    }
+    l->sum_us += t;
+    l->count++;
+    if( t < l->min_us )
+        l->min_us = t;
+    if( t > l->max_us )
+        l->max_us = t;
+}
+
+/* Average, or 0 if there's nothing recorded */
+static inline uint16_t latency_avg( const LatencyStats *l )
+{
+    return l->count ? (uint16_t)( l->sum_us / l->count ) : 0;
+}
+
+#endif
@@ -0,0 +1,172 @@
+/*
+  NunchukDAC.cpp
+  
+  Fixed-rate control pipeline from a Nunchuk to the two channels of a TLV5618 DAC.
+  The device side (poll()) is the NunchukDAC_T template in NunchukDAC.h; this is the rest.
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#include "Arduino.h"
+#include <SPI.h>
+#include <Wire.h>
+#include <I2CBus.h>
+#include <TransportI2C.h>
+#include <TransportSPI.h>
+#include <TLV5618.h>
+#include <Nunchuk.h>
+
+#include "NunchukDAC.h"
+
+
+NunchukDACBase::NunchukDACBase()
+{
+  uint8_t ch;
+  
+  for( ch = 0; ch < 2; ch++ )
+  {
+    _source[ch] = NUNCHUKDAC_ACCEL_X + ch;
+    _curve[ch] = 0;
+    _scale[ch] = 0;
+    _out[ch] = 0;
+  }
+  _period_us = 0;
+  _acquire_us = NUNCHUKDAC_ACQUIRE_MICROSEC;
+  _next = 0;
+  _requested = 0;
+  _sampled = 0;
+  _acquiring = 0;
+  resetStats();
+}
+
+
+/* Use this input and curve for a DAC channel.  The curve isn't copied; keep it around.
+   With no curve (0) the channel outputs 0. */
+void NunchukDACBase::setSource( uint8_t channel, uint8_t source, const NunchukDAC_curve* curve )
+{
+  channel &= 1;
+  _source[channel] = source;
+  _curve[channel] = curve;
+  
+  // Precompute the scaling so there's no division per sample
+  if( curve && curve->in_max > curve->in_min )
+    _scale[channel] = ((uint32_t)NUNCHUKDAC_CURVE_STEPS << 16) / (uint32_t)( curve->in_max - curve->in_min );
+  else
+    _scale[channel] = 0;
+}
+
+/* Fill in a straight-line curve: in_min gives 0, in_max gives 4095 */
+void NunchukDACBase::linearCurve( NunchukDAC_curve* curve, int16_t in_min, int16_t in_max )
+{
+  uint8_t i;
+  
+  curve->in_min = in_min;
+  curve->in_max = in_max;
+  for( i = 0; i < NUNCHUKDAC_CURVE_POINTS; i++ )
+    curve->points[i] = (uint16_t)( ( 4095UL * i ) / NUNCHUKDAC_CURVE_STEPS );
+}
+
+
+/* Start running, one period from now.  The Nunchuk and DAC should already be initialized. */
+void NunchukDACBase::begin( unsigned long period_us, unsigned long acquire_us )
+{
+  _period_us = period_us;
+  _acquire_us = ( acquire_us < period_us ) ? acquire_us : period_us / 2;
+  _acquiring = 0;
+  _next = micros() + period_us;
+}
+
+
+/* If a period is due, account for its start (jitter, missed periods) and schedule the next */
+uint8_t NunchukDACBase::_periodStart( unsigned long now )
+{
+  unsigned long late;
+  
+  if( _period_us==0 || (long)( now - _next ) < 0 )
+    return 0;
+  
+  late = now - _next;
+  if( late > 0xFFFF )
+    late = 0xFFFF;
+  if( late > _stats.jitter_max_us )
+    _stats.jitter_max_us = late;
+  
+  _next += _period_us;
+  if( (long)( now - _next ) >= 0 )
+  {
+    // Far behind; don't try to catch up
+    _stats.missed++;
+    _next = now + _period_us;
+  }
+  return 1;
+}
+
+/* The outputs were just written */
+void NunchukDACBase::_written()
+{
+  _stats.periods++;
+  latency_record( &_stats.latency, micros() - _requested );
+}
+
+
+int NunchukDACBase::_input( NunchukBase& nc, uint8_t source )
+{
+  switch( source )
+  {
+    case NUNCHUKDAC_ACCEL_X: return nc.getAccelX();
+    case NUNCHUKDAC_ACCEL_Y: return nc.getAccelY();
+    case NUNCHUKDAC_ACCEL_Z: return nc.getAccelZ();
+    case NUNCHUKDAC_JOY_X:   return nc.getJoyX();
+    case NUNCHUKDAC_JOY_Y:   return nc.getJoyY();
+  }
+  return 0;
+}
+
+/* Piecewise-linear interpolation through the channel's curve; integers only */
+uint16_t NunchukDACBase::_map( uint8_t channel, int x )
+{
+  const NunchukDAC_curve* c = _curve[channel];
+  uint32_t pos;
+  uint8_t i, frac;
+  uint16_t p0, p1;
+  
+  if( c==0 )
+    return 0;
+  if( x <= c->in_min )
+    return c->points[0];
+  if( x >= c->in_max )
+    return c->points[NUNCHUKDAC_CURVE_STEPS];
+  
+  pos = (uint32_t)( x - c->in_min ) * _scale[channel];     // 16.16 steps
+  i = pos >> 16;
+  if( i >= NUNCHUKDAC_CURVE_STEPS )
+    return c->points[NUNCHUKDAC_CURVE_STEPS];
+  frac = (uint8_t)( pos >> 8 );
+  
+  p0 = c->points[i];
+  p1 = c->points[i+1];
+  if( p1 >= p0 )
+    return p0 + (uint16_t)( ( (uint32_t)( p1 - p0 ) * frac ) >> 8 );
+  else
+    return p0 - (uint16_t)( ( (uint32_t)( p0 - p1 ) * frac ) >> 8 );
+}
+
+void NunchukDACBase::_mapInputs( NunchukBase& nc )
+{
+  _out[0] = _map( 0, _input( nc, _source[0] ) );
+  _out[1] = _map( 1, _input( nc, _source[1] ) );
+}
+
+
+/* Statistics */
+
+uint16_t NunchukDACBase::getLatencyAvg()
+{
+  return latency_avg( &_stats.latency );
+}
+
+void NunchukDACBase::resetStats()
+{
+  memset( &_stats, 0, sizeof(_stats) );
+  latency_reset( &_stats.latency );
+}
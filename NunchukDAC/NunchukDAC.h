@@ -0,0 +1,162 @@
+/*
+  NunchukDAC.h
+  
+  Fixed-rate control pipeline from a Nunchuk to the two channels of a TLV5618 DAC.
+  
+  Each period:
+    - request(): the Nunchuk samples its inputs
+    - after a short acquire time, fetch() the sample
+    - map each channel's input through an integer curve table (no floating point)
+    - write both DAC channels
+  The latency from request() to the end of the DAC write is mostly bus time plus the acquire time:
+  about 0.5ms with the I2C bus at 400kHz, but about 1.1ms at the default 100kHz.
+  So call I2CBus.begin(400000) before the Nunchuk's begin() (the first begin() sets the clock).
+  That only sets the rate on AVR; on other cores (e.g. Teensy 3.x) the bus stays at 100kHz, so expect about 1.1ms.
+  
+  To use:
+    include <Wire.h>, <SPI.h>, <I2CBus.h>, <TransportI2C.h>, <TransportSPI.h>, <TLV5618.h> and <Nunchuk.h> in your sketch before this library.
+    NunchukDAC uses the default transports: Nunchuk on the shared Wire bus, DAC on hardware SPI.
+    For others, use NunchukDAC_T<nunchuk type, DAC type>, e.g. NunchukDAC_T< Nunchuk_T< SoftI2CTransport<2,3> >, TLV5618 >.
+    Construct with your Nunchuk and TLV5618, and begin() them both in your setup() (after I2CBus.begin(400000)),
+    set up each channel with setSource(),
+    call begin() with the control period,
+    call poll() from loop() as often as you can.  Don't use delay() in loop()!
+  poll() is driven by micros() rather than a timer interrupt, because the Nunchuk and DAC calls block.
+  
+  Statistics (getStats()) give the input-to-output latency, and the jitter of each period's start.
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#ifndef __NUNCHUKDAC_H__
+#define __NUNCHUKDAC_H__
+
+#include "Arduino.h"
+#include <TLV5618.h>
+#include <Nunchuk.h>
+#include <LatencyStats.h>
+
+/* Inputs */
+#define NUNCHUKDAC_ACCEL_X   0
+#define NUNCHUKDAC_ACCEL_Y   1
+#define NUNCHUKDAC_ACCEL_Z   2
+#define NUNCHUKDAC_JOY_X     3
+#define NUNCHUKDAC_JOY_Y     4
+
+#define NUNCHUKDAC_CHANNEL_A 0
+#define NUNCHUKDAC_CHANNEL_B 1
+
+/* Curve tables have this many points, spaced evenly across the input range */
+#define NUNCHUKDAC_CURVE_STEPS   16
+#define NUNCHUKDAC_CURVE_POINTS  (NUNCHUKDAC_CURVE_STEPS+1)
+
+#define NUNCHUKDAC_ACQUIRE_MICROSEC  300    /* default time from the end of request() to fetch() */
+
+
+/* Mapping from an input to the DAC.  Inputs outside the range are clamped. */
+typedef struct {
+  int16_t in_min;
+  int16_t in_max;
+  uint16_t points[NUNCHUKDAC_CURVE_POINTS];     /* output, 0 to 4095, at in_min, ..., in_max */
+} NunchukDAC_curve;
+
+
+/* Pipeline statistics */
+typedef struct {
+  uint32_t periods;             /* outputs written */
+  uint16_t missed;              /* periods skipped because poll() was too late */
+  uint16_t sensor_errors;       /* fetch() failed; outputs held */
+  LatencyStats latency;         /* request() to end of DAC write */
+  uint16_t jitter_max_us;       /* lateness of a period's start */
+} NunchukDAC_stats;
+
+
+/* The curves, mapping, scheduling and statistics; NunchukDAC_T adds the Nunchuk and the DAC */
+class NunchukDACBase
+{
+  protected:
+    uint8_t _source[2];
+    const NunchukDAC_curve* _curve[2];
+    uint32_t _scale[2];         /* curve steps per input unit, 16.16 fixed point */
+    uint16_t _out[2];
+    
+    unsigned long _period_us;
+    unsigned long _acquire_us;
+    unsigned long _next;        /* start of the next period */
+    unsigned long _requested;   /* when this period's request() started (for the latency) */
+    unsigned long _sampled;     /* when it finished (for the acquire time) */
+    uint8_t _acquiring;
+    
+    NunchukDAC_stats _stats;
+    
+    uint8_t _periodStart( unsigned long now );
+    void _mapInputs( NunchukBase& nc );
+    void _written();
+    int _input( NunchukBase& nc, uint8_t source );
+    uint16_t _map( uint8_t channel, int x );
+    
+  public:
+    NunchukDACBase();
+    
+    void setSource( uint8_t channel, uint8_t source, const NunchukDAC_curve* curve );
+    static void linearCurve( NunchukDAC_curve* curve, int16_t in_min, int16_t in_max );
+    
+    void begin( unsigned long period_us, unsigned long acquire_us = NUNCHUKDAC_ACQUIRE_MICROSEC );
+    
+    uint16_t getOutput( uint8_t channel ) { return _out[channel & 1]; };
+    const NunchukDAC_stats& getStats() { return _stats; };
+    uint16_t getLatencyAvg();   /* microseconds */
+    void resetStats();
+};
+
+
+/* NC_T is a Nunchuk_T (on any I2C transport), DAC_T a TLV5618_T (on any SPI transport) */
+template<class NC_T, class DAC_T>
+class NunchukDAC_T : public NunchukDACBase
+{
+  private:
+    NC_T& _nc;
+    DAC_T& _dac;
+    
+  public:
+    NunchukDAC_T( NC_T& nc, DAC_T& dac ) : _nc( nc ), _dac( dac ) {};
+    
+    /* Run whichever stage is due.  Call this as often as possible.  Returns 1 when the outputs were just written. */
+    uint8_t poll()
+    {
+      unsigned long now = micros();
+      
+      if( _acquiring )
+      {
+        if( (long)( now - _sampled ) < (long)_acquire_us )
+          return 0;
+        _acquiring = 0;
+        
+        if( _nc.fetch() != NUNCHUK_READ_OK )
+        {
+          // Hold the outputs where they were
+          _stats.sensor_errors++;
+          return 0;
+        }
+        _mapInputs( _nc );
+        _dac.write( _out[0], _out[1] );
+        _written();
+        return 1;
+      }
+      
+      if( !_periodStart( now ) )
+        return 0;
+      
+      // Sample the inputs
+      _requested = now;
+      _nc.request();
+      _sampled = micros();
+      _acquiring = 1;
+      return 0;
+    };
+};
+
+/* The Nunchuk on the shared Wire bus, the DAC on hardware SPI */
+typedef NunchukDAC_T<Nunchuk, TLV5618> NunchukDAC;
+
+#endif
@@ -2,12 +2,13 @@
   TLV5618.h
   
   Arduino library for Texas Instruments TLV5618 2-channel 12-bit SPI DAC
+  Partially based on the Wiblocks library http://wiblocks.luciani.org/src/lib/DAC/classDAC__TLV5618.html
   
   External voltage reference; full-scale is 2*vref
   Values here are uint16, valid from 0 to 4096.
   
   To use:
-    include <SPI.h> in your sketch before this library.
+    include <SPI.h> and <TransportSPI.h> in your sketch before this library.
     Construct,
     call begin() in your setup(),
     call write().
@@ -18,6 +19,20 @@
       For "classic" Arduinos (Uno, Duemilanove, etc.), data = pin 11, clock = pin 13
       For Teensy 2.0, data = B2 (#2), clock = B1 (#1)
       For Teensy 3.0, data = 11 (DOUT), clock = 13 (SCK)
+    Or, for any other pins, use a bit-banged transport:
+      TLV5618_T< SoftSPITransport<data_pin,clock_pin> > dac( cs_pin );
+    or, on Teensy 3.x, to send the frames by DMA:
+      TLV5618_T< DMASPITransport<> > dac( cs_pin );
+    (see TransportSPI.h for the others, and TransportMock.h for MockSPITransport).
+  
+  Cost per call (bus bytes, !CS edges, blocking delayMicroseconds):
+    write_data()        2 bytes, 2 edges,  2uS
+    write_data_no_cs()  2 bytes, 0 edges,  0uS  (caller handles !CS)
+    write_fast()        2 bytes, 2 edges,  0uS  (interrupts off during the transfer, then back as they were; on AVR skips the SPI library)
+    write()             4 bytes, 4 edges,  5uS
+    select()            0 bytes, 1 edge,  10uS
+    On AVR each digitalWrite() is a few uS more, which is more than a byte at SPI_CLOCK_DIV2.
+    TLV5618_T<MockSPITransport> counts these for you (in its "spi" member).
     
   2012-09-29 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
 */
@@ -26,6 +41,7 @@
 #define __TLV5618_H__
 
 #include "Arduino.h"
+#include <TransportSPI.h>
 
 /* Optionally you can pass these control modes to the constructor.  Default is "slow" (10uS settling) */
 #define TLV5618_SPEED_SLOW  0x00
@@ -42,26 +58,83 @@
 #define TLV5618_CMD_WRITE_A_UPDATE_B   0x80
 
 
-class TLV5618
+template<class SPI_T>
+class TLV5618_T
 {
   private:
     uint8_t _cs_pin;
     uint8_t _control;
     
   public:
-    TLV5618( uint8_t cs_pin );
-    TLV5618( uint8_t cs_pin, uint8_t control );
+    SPI_T spi;    /* the transport */
+    
+    TLV5618_T( uint8_t cs_pin ) : _cs_pin( cs_pin ), _control( TLV5618_SPEED_SLOW | TLV5618_POWER_NORM ) {};
+    TLV5618_T( uint8_t cs_pin, uint8_t control ) : _cs_pin( cs_pin ), _control( control ) {};
 
-    void begin();
+    void begin()
+    {
+      /* Initialize SPI */
+      spi.begin( SPI_MODE3, SPI_CLOCK_DIV2 );  // (you could try other speeds)
+      
+      /* !Chip select (low to enable) */
+      spi.beginSelect( _cs_pin );
+    };
     
     // Direct write methods
-    void select( int b );
-    inline void write_data_no_cs( uint8_t cmd, uint16_t value ) { SPI.transfer( ((value & 0xF00)>>8) | cmd | _control ); SPI.transfer(   value & 0xFF ); };
-    void write_data( uint8_t cmd, uint16_t value );
-    void write_fast( uint8_t cmd, uint16_t value );
+    
+    /* Chip-select (1 to select) */
+    void select( int b )
+    {
+      spi.select( _cs_pin, !b );
+      spi.delayMicros( 10 );
+    };
+    
+    /* Write without chip-select */
+    inline void write_data_no_cs( uint8_t cmd, uint16_t value )
+    {
+      uint8_t frame[2] = { (uint8_t)( ((value & 0xF00)>>8) | cmd | _control ), (uint8_t)( value & 0xFF ) };
+      spi.write( frame, 2 );
+    };
+    
+    /* Write using one of the TLV5618_CMD_xxx */
+    void write_data( uint8_t cmd, uint16_t value )
+    {
+      spi.select( _cs_pin, 0 );
+      spi.delayMicros( 1 );
+      write_data_no_cs( cmd, value );
+      spi.delayMicros( 1 );
+      spi.select( _cs_pin, 1 );
+    };
+    
+    void write_fast( uint8_t cmd, uint16_t value )
+    {
+      uint8_t irq;
+      spi.select( _cs_pin, 0 );
+      irq = spi.irqOff();
+      spi.transferFast( ((value & 0x0F00)>>8) | cmd | _control );
+      spi.transferFast(   value & 0xFF );
+      spi.irqRestore( irq );
+      spi.select( _cs_pin, 1 );
+    };
     
     // Convenience write both channels
-    void write( uint16_t valueA, uint16_t valueB );
+    void write( uint16_t valueA, uint16_t valueB )
+    {
+      spi.select( _cs_pin, 0 );
+      spi.delayMicros( 1 );
+      write_data_no_cs( TLV5618_CMD_WRITE_BUFFER, valueA );
+      spi.delayMicros( 1 );
+      spi.select( _cs_pin, 1 );
+      spi.delayMicros( 1 );
+      spi.select( _cs_pin, 0 );
+      spi.delayMicros( 1 );
+      write_data_no_cs( TLV5618_CMD_WRITE_A_UPDATE_B, valueB );
+      spi.delayMicros( 1 );
+      spi.select( _cs_pin, 1 );
+    };
 };
 
+/* The DAC on the hardware SPI pins */
+typedef TLV5618_T<HardwareSPITransport> TLV5618;
+
 #endif
@@ -0,0 +1,183 @@
+/*
+  TransportI2C.h
+  
+  I2C transport policies for the machinesalem drivers (WM8731_T, Nunchuk_T).
+  Each driver is a template on one of these, so the bus calls are inlined; there are no virtual functions.
+  
+  I2C transports have:
+    void begin( uint8_t priority, uint16_t max_hold_us );      (priority and hold time only matter for the shared bus)
+    uint8_t write( uint8_t address, const uint8_t *data, uint8_t len );
+    uint8_t read( uint8_t address, uint8_t *data, uint8_t len );
+    uint8_t post( uint8_t address, const uint8_t *data, uint8_t len );     (queued on the shared bus; immediate otherwise)
+  returning I2CBUS_xxx status codes.
+    SharedWireTransport     Wire, through the I2CBus arbiter (the default)
+    WireTransport           Wire, directly
+    SoftI2CTransport<sda,scl,half_period_us>    bit-banged on any two pins.  Needs pullups.  No clock stretching.
+  MockI2CTransport is in TransportMock.h.
+  
+  There's no DMA transport: Wire has no DMA path (on AVR it runs from the TWI interrupt, on Teensy 3.x
+  it polls the I2C0 registers byte by byte), and the largest transfer here is 7 bytes.
+  
+  Requires the Wire library and I2CBus.  Your sketch should #include <Wire.h>, <I2CBus.h> and <TransportI2C.h>.
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#ifndef __TRANSPORTI2C_H__
+#define __TRANSPORTI2C_H__
+
+#include "Arduino.h"
+#include <Wire.h>
+#include <I2CBus.h>
+
+
+class SharedWireTransport
+{
+  private:
+    uint8_t _client;
+    
+  public:
+    SharedWireTransport() : _client( I2CBUS_NO_CLIENT ) {};
+    
+    inline void begin( uint8_t priority, uint16_t max_hold_us )
+    {
+      I2CBus.begin();
+      if( _client==I2CBUS_NO_CLIENT )
+        _client = I2CBus.addClient( priority, max_hold_us );
+    };
+    inline uint8_t write( uint8_t address, const uint8_t *data, uint8_t len ) { return I2CBus.write( _client, address, data, len ); };
+    inline uint8_t read( uint8_t address, uint8_t *data, uint8_t len ) { return I2CBus.read( _client, address, data, len ); };
+    inline uint8_t post( uint8_t address, const uint8_t *data, uint8_t len ) { return I2CBus.post( _client, address, data, len ); };
+    
+    inline uint8_t client() { return _client; };     /* for I2CBus.getStats() */
+};
+
+
+class WireTransport
+{
+  public:
+    inline void begin( uint8_t, uint16_t ) { Wire.begin(); };
+    
+    inline uint8_t write( uint8_t address, const uint8_t *data, uint8_t len )
+    {
+      Wire.beginTransmission( address );
+      Wire.write( data, len );
+      return ( Wire.endTransmission()==0 ) ? I2CBUS_OK : I2CBUS_NACK;
+    };
+    
+    inline uint8_t read( uint8_t address, uint8_t *data, uint8_t len )
+    {
+      uint8_t n = 0;
+      Wire.requestFrom( address, len );
+      while( Wire.available() )
+      {
+        uint8_t b = (uint8_t)Wire.read();
+        if( n < len )
+          data[n++] = b;
+      }
+      return ( n==len ) ? I2CBUS_OK : I2CBUS_SHORT;
+    };
+    
+    inline uint8_t post( uint8_t address, const uint8_t *data, uint8_t len ) { return write( address, data, len ); };
+};
+
+
+template<uint8_t SDA_PIN, uint8_t SCL_PIN, uint8_t HALF_PERIOD_US = 5>
+class SoftI2CTransport
+{
+  private:
+    /* Open-drain: pull low, or let the pullup take it high */
+    inline void _low( uint8_t pin )     { digitalWrite( pin, LOW ); pinMode( pin, OUTPUT ); };
+    inline void _release( uint8_t pin ) { pinMode( pin, INPUT ); };
+    inline void _wait()                 { delayMicroseconds( HALF_PERIOD_US ); };
+    
+    void _start()
+    {
+      _release( SDA_PIN ); _release( SCL_PIN ); _wait();
+      _low( SDA_PIN ); _wait();
+      _low( SCL_PIN );
+    };
+    
+    void _stop()
+    {
+      _low( SDA_PIN ); _wait();
+      _release( SCL_PIN ); _wait();
+      _release( SDA_PIN ); _wait();
+    };
+    
+    /* Returns true if the device acknowledged */
+    bool _write_byte( uint8_t b )
+    {
+      uint8_t i;
+      bool ack;
+      
+      for( i = 0; i < 8; i++, b <<= 1 )
+      {
+        if( b & 0x80 ) _release( SDA_PIN ); else _low( SDA_PIN );
+        _wait();
+        _release( SCL_PIN ); _wait();
+        _low( SCL_PIN );
+      }
+      _release( SDA_PIN ); _wait();
+      _release( SCL_PIN ); _wait();
+      ack = ( digitalRead( SDA_PIN )==LOW );
+      _low( SCL_PIN );
+      return ack;
+    };
+    
+    uint8_t _read_byte( bool ack )
+    {
+      uint8_t i, b = 0;
+      
+      _release( SDA_PIN );
+      for( i = 0; i < 8; i++ )
+      {
+        _wait();
+        _release( SCL_PIN ); _wait();
+        b = ( b << 1 ) | ( digitalRead( SDA_PIN )==HIGH ? 1 : 0 );
+        _low( SCL_PIN );
+      }
+      if( ack ) _low( SDA_PIN ); else _release( SDA_PIN );
+      _wait();
+      _release( SCL_PIN ); _wait();
+      _low( SCL_PIN );
+      _release( SDA_PIN );
+      return b;
+    };
+    
+  public:
+    inline void begin( uint8_t, uint16_t ) { _release( SDA_PIN ); _release( SCL_PIN ); };
+    
+    uint8_t write( uint8_t address, const uint8_t *data, uint8_t len )
+    {
+      uint8_t i;
+      bool ok;
+      
+      _start();
+      ok = _write_byte( address << 1 );
+      for( i = 0; ok && i < len; i++ )
+        ok = _write_byte( data[i] );
+      _stop();
+      return ok ? I2CBUS_OK : I2CBUS_NACK;
+    };
+    
+    uint8_t read( uint8_t address, uint8_t *data, uint8_t len )
+    {
+      uint8_t i;
+      
+      _start();
+      if( !_write_byte( ( address << 1 ) | 1 ) )
+      {
+        _stop();
+        return I2CBUS_SHORT;
+      }
+      for( i = 0; i < len; i++ )
+        data[i] = _read_byte( i+1 < len );
+      _stop();
+      return I2CBUS_OK;
+    };
+    
+    inline uint8_t post( uint8_t address, const uint8_t *data, uint8_t len ) { return write( address, data, len ); };
+};
+
+#endif
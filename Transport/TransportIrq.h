@@ -0,0 +1,45 @@
+/*
+  TransportIrq.h
+  
+  Interrupts off, and back to how they were, for the short critical sections in the transports and I2CBus.
+  Saves SREG on AVR and PRIMASK on ARM (e.g. Teensy 3.x), so it's safe to use inside an interrupt handler.
+  Elsewhere it falls back to noInterrupts() and interrupts(), which always turns them back on.
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#ifndef __TRANSPORTIRQ_H__
+#define __TRANSPORTIRQ_H__
+
+#include "Arduino.h"
+
+/* Interrupts off; returns the previous state for transport_irq_restore() */
+static inline uint8_t transport_irq_off()
+{
+#if defined(SREG)
+  uint8_t sreg = SREG;
+  cli();
+  return sreg;
+#elif defined(__arm__)
+  uint32_t primask;
+  __asm__ volatile( "mrs %0, primask\n\tcpsid i" : "=r" (primask) :: "memory" );
+  return (uint8_t)primask;
+#else
+  noInterrupts();
+  return 1;
+#endif
+}
+
+static inline void transport_irq_restore( uint8_t state )
+{
+#if defined(SREG)
+  SREG = state;
+#elif defined(__arm__)
+  __asm__ volatile( "msr primask, %0" :: "r" ((uint32_t)state) : "memory" );
+#else
+  if( state )
+    interrupts();
+#endif
+}
+
+#endif
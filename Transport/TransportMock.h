@@ -0,0 +1,127 @@
+/*
+  TransportMock.h
+
+  Recording transports, for counting what a driver puts on the bus (e.g. TLV5618_T<MockSPITransport>).
+  They don't touch any pins or call the Arduino core, so they also build on a PC.
+
+    MockI2CTransport        records the bytes; read() returns the reply bytes you set
+    MockSPITransport        records the bytes, chip-select edges, delays and interrupts-off sections
+
+  The interfaces are as described in TransportI2C.h and TransportSPI.h.
+
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#ifndef __TRANSPORTMOCK_H__
+#define __TRANSPORTMOCK_H__
+
+#include <stdint.h>
+#include <I2CBusStatus.h>
+
+#define TRANSPORT_MOCK_LOG_SIZE   64    /* bytes recorded by the mock transports */
+#define TRANSPORT_MOCK_REPLY_SIZE 8
+#define TRANSPORT_MOCK_PINS       64    /* chip-select levels tracked; higher pins count an edge on every select() */
+
+
+class MockI2CTransport
+{
+  public:
+    uint8_t log[TRANSPORT_MOCK_LOG_SIZE];       /* for each transaction: address byte (with R/W bit), then the data written or read */
+    uint16_t bytes;                             /* total bytes, including any that didn't fit in the log */
+    uint16_t transactions;
+    uint8_t reply[TRANSPORT_MOCK_REPLY_SIZE];   /* what read() returns */
+    uint8_t reply_len;
+
+    MockI2CTransport() { clear(); reply_len = 0; };
+
+    inline void clear() { bytes = 0; transactions = 0; };
+    inline void begin( uint8_t, uint16_t ) {};
+
+    uint8_t write( uint8_t address, const uint8_t *data, uint8_t len )
+    {
+      uint8_t i;
+      transactions++;
+      _record( address << 1 );
+      for( i = 0; i < len; i++ )
+        _record( data[i] );
+      return I2CBUS_OK;
+    };
+
+    uint8_t read( uint8_t address, uint8_t *data, uint8_t len )
+    {
+      uint8_t i;
+      transactions++;
+      _record( ( address << 1 ) | 1 );
+      for( i = 0; i < len && i < reply_len; i++ )
+      {
+        data[i] = reply[i];
+        _record( reply[i] );
+      }
+      return ( i==len ) ? I2CBUS_OK : I2CBUS_SHORT;
+    };
+
+    inline uint8_t post( uint8_t address, const uint8_t *data, uint8_t len ) { return write( address, data, len ); };
+
+  private:
+    inline void _record( uint8_t b )
+    {
+      if( bytes < TRANSPORT_MOCK_LOG_SIZE )
+        log[bytes] = b;
+      bytes++;
+    };
+};
+
+
+class MockSPITransport
+{
+  public:
+    uint8_t log[TRANSPORT_MOCK_LOG_SIZE];
+    uint16_t bytes;             /* total bytes, including any that didn't fit in the log */
+    uint16_t select_edges;      /* changes of a chip-select pin */
+    uint32_t delay_us;          /* total delayMicros() time requested */
+    uint16_t irq_sections;      /* irqOff() calls */
+
+    /* Pins start low, as after reset; beginSelect() sets the idle level without counting an edge */
+    MockSPITransport() { uint8_t i; for( i = 0; i < sizeof(_high); i++ ) _high[i] = 0; clear(); };
+
+    /* Clears the counts, not the pin levels */
+    inline void clear() { bytes = 0; select_edges = 0; delay_us = 0; irq_sections = 0; };
+    inline void begin( uint8_t, uint8_t ) {};
+    inline void beginSelect( uint8_t pin ) { _set( pin, 1 ); };
+    inline uint8_t transfer( uint8_t b )
+    {
+      if( bytes < TRANSPORT_MOCK_LOG_SIZE )
+        log[bytes] = b;
+      bytes++;
+      return 0;
+    };
+    inline void transferFast( uint8_t b ) { transfer( b ); };
+    inline void write( const uint8_t *data, uint8_t len ) { while( len-- ) transfer( *data++ ); };
+    inline void select( uint8_t pin, uint8_t level )
+    {
+      if( pin >= TRANSPORT_MOCK_PINS || selectLevel( pin ) != ( level ? 1 : 0 ) )
+        select_edges++;
+      _set( pin, level );
+    };
+    inline void delayMicros( unsigned int us ) { delay_us += us; };
+    inline uint8_t irqOff() { irq_sections++; return 1; };
+    inline void irqRestore( uint8_t ) {};
+
+    /* Current level of a chip-select pin */
+    inline uint8_t selectLevel( uint8_t pin ) { return pin < TRANSPORT_MOCK_PINS ? ( _high[pin>>3] >> ( pin & 7 ) ) & 1 : 0; };
+
+  private:
+    uint8_t _high[TRANSPORT_MOCK_PINS/8];
+
+    inline void _set( uint8_t pin, uint8_t level )
+    {
+      if( pin >= TRANSPORT_MOCK_PINS )
+        return;
+      if( level )
+        _high[pin>>3] |= ( 1 << ( pin & 7 ) );
+      else
+        _high[pin>>3] &= ~( 1 << ( pin & 7 ) );
+    };
+};
+
+#endif
@@ -0,0 +1,208 @@
+/*
+  TransportSPI.h
+
+  SPI transport policies for the machinesalem drivers (TLV5618_T).
+  Each driver is a template on one of these, so the bus calls are inlined; there are no virtual functions.
+
+  SPI transports have:
+    void begin( uint8_t data_mode, uint8_t clock_divider );    (SPI_MODEx and SPI_CLOCK_DIVx)
+    void beginSelect( uint8_t pin );    (make a chip-select pin an output, idle high)
+    uint8_t transfer( uint8_t b );
+    void transferFast( uint8_t b );     (no return value; AVR hardware SPI skips the library call)
+    void write( const uint8_t *data, uint8_t len );    (a block; by DMA where there is one)
+    void select( uint8_t pin, uint8_t level );
+    void delayMicros( unsigned int us );
+    uint8_t irqOff();                   (interrupts off; returns the previous state)
+    void irqRestore( uint8_t state );   (put back what irqOff() returned)
+    HardwareSPITransport    SPI
+    DMASPITransport<channel>    SPI, with write() by DMA (Teensy 3.x only; not yet tested, see below)
+    SoftSPITransport<mosi,sck>      bit-banged on any two pins (write only)
+  MockSPITransport is in TransportMock.h.
+
+  Requires the SPI library.  Your sketch should #include <SPI.h> and <TransportSPI.h>.
+
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#ifndef __TRANSPORTSPI_H__
+#define __TRANSPORTSPI_H__
+
+#include "Arduino.h"
+#include <SPI.h>
+#include "TransportIrq.h"
+
+#define TRANSPORT_DMA_MAX_BYTES 16      /* DMASPITransport sends longer blocks in pieces this size */
+
+
+class HardwareSPITransport
+{
+  public:
+    inline void begin( uint8_t data_mode, uint8_t clock_divider )
+    {
+      SPI.begin();
+      SPI.setBitOrder( MSBFIRST );
+      SPI.setDataMode( data_mode );
+      SPI.setClockDivider( clock_divider );
+    };
+    /* High before output, so the pin doesn't glitch low */
+    inline void beginSelect( uint8_t pin ) { digitalWrite( pin, HIGH ); pinMode( pin, OUTPUT ); };
+    inline uint8_t transfer( uint8_t b ) { return SPI.transfer( b ); };
+    inline void transferFast( uint8_t b )
+    {
+#ifdef SPDR
+      SPDR = b;
+      while( !( SPSR & (1<<SPIF) ) );
+#else
+      SPI.transfer( b );
+#endif
+    };
+    inline void write( const uint8_t *data, uint8_t len ) { while( len-- ) SPI.transfer( *data++ ); };
+    inline void select( uint8_t pin, uint8_t level ) { digitalWrite( pin, level ); };
+    inline void delayMicros( unsigned int us ) { delayMicroseconds( us ); };
+    inline uint8_t irqOff() { return transport_irq_off(); };
+    inline void irqRestore( uint8_t state ) { transport_irq_restore( state ); };
+};
+
+
+#if defined(__MK20DX128__) || defined(__MK20DX256__)
+/*
+  Teensy 3.x: write() feeds the SPI0 transmit FIFO by DMA, one 32-bit PUSHR command per byte,
+  and waits for the end-of-queue flag on the last one.  Everything else is the SPI library.
+  The CPU isn't free while it waits, but there's no per-byte loop or interrupt latency between bytes.
+  DMA_CHANNEL must not be used by anything else (e.g. the Audio library); 0 to 3 on the MK20DX128.
+  UNTESTED: this hasn't been built against the Teensyduino core or run on a Teensy, and no host target
+  compiles it (the host build isn't a Teensy).  Check it on hardware before relying on it.
+*/
+typedef struct {
+  volatile const void *saddr;
+  volatile int16_t soff;
+  volatile uint16_t attr;
+  volatile uint32_t nbytes;
+  volatile int32_t slast;
+  volatile void *daddr;
+  volatile int16_t doff;
+  volatile uint16_t citer;
+  volatile int32_t dlastsga;
+  volatile uint16_t csr;
+  volatile uint16_t biter;
+} TransportDMA_TCD;
+
+#define TRANSPORT_DMA_TCD(ch)     ( (TransportDMA_TCD *)( 0x40009000 + 32*(ch) ) )
+#define TRANSPORT_DMAMUX_CHCFG(ch) ( (&DMAMUX0_CHCFG0)[ch] )
+
+template<uint8_t DMA_CHANNEL = 0>
+class DMASPITransport
+{
+  private:
+    uint32_t _cmd[TRANSPORT_DMA_MAX_BYTES];     /* PUSHR commands: CTAR0, data in the low byte */
+
+    void _block( const uint8_t *data, uint8_t len )
+    {
+      TransportDMA_TCD *tcd = TRANSPORT_DMA_TCD( DMA_CHANNEL );
+      uint32_t rser = SPI0_RSER;
+      uint8_t i;
+
+      for( i = 0; i < len; i++ )
+        _cmd[i] = data[i];
+      _cmd[len-1] |= SPI_PUSHR_EOQ;
+
+      tcd->saddr = _cmd;
+      tcd->soff = 4;
+      tcd->attr = DMA_TCD_ATTR_SSIZE(2) | DMA_TCD_ATTR_DSIZE(2);
+      tcd->nbytes = 4;
+      tcd->slast = 0;
+      tcd->daddr = &SPI0_PUSHR;
+      tcd->doff = 0;
+      tcd->citer = len;
+      tcd->biter = len;
+      tcd->dlastsga = 0;
+      tcd->csr = DMA_TCD_CSR_DREQ;      /* stop requests at the end */
+
+      SPI0_SR = SPI_SR_EOQF | SPI_SR_TCF | SPI_SR_RFOF;
+      __asm__ volatile( "" ::: "memory" );      /* _cmd is written before the DMA reads it */
+      SPI0_RSER = rser | SPI_RSER_TFFF_RE | SPI_RSER_TFFF_DIRS;
+      DMA_SERQ = DMA_CHANNEL;
+
+      while( !( SPI0_SR & SPI_SR_EOQF ) );
+
+      SPI0_RSER = rser;
+      DMA_CDNE = DMA_CHANNEL;
+      SPI0_MCR |= SPI_MCR_CLR_RXF;      /* nobody wants what came back */
+      SPI0_SR = SPI_SR_EOQF | SPI_SR_RFOF;      /* and carry on with transfer() */
+    };
+
+  public:
+    inline void begin( uint8_t data_mode, uint8_t clock_divider )
+    {
+      SPI.begin();
+      SPI.setBitOrder( MSBFIRST );
+      SPI.setDataMode( data_mode );
+      SPI.setClockDivider( clock_divider );
+      SIM_SCGC6 |= SIM_SCGC6_DMAMUX;
+      SIM_SCGC7 |= SIM_SCGC7_DMA;
+      TRANSPORT_DMAMUX_CHCFG( DMA_CHANNEL ) = 0;
+      TRANSPORT_DMAMUX_CHCFG( DMA_CHANNEL ) = DMAMUX_SOURCE_SPI0_TX | DMAMUX_ENABLE;
+    };
+    inline void beginSelect( uint8_t pin ) { digitalWrite( pin, HIGH ); pinMode( pin, OUTPUT ); };
+    inline uint8_t transfer( uint8_t b ) { return SPI.transfer( b ); };
+    inline void transferFast( uint8_t b ) { SPI.transfer( b ); };
+    void write( const uint8_t *data, uint8_t len )
+    {
+      while( len > TRANSPORT_DMA_MAX_BYTES )
+      {
+        _block( data, TRANSPORT_DMA_MAX_BYTES );
+        data += TRANSPORT_DMA_MAX_BYTES;
+        len -= TRANSPORT_DMA_MAX_BYTES;
+      }
+      if( len )
+        _block( data, len );
+    };
+    inline void select( uint8_t pin, uint8_t level ) { digitalWrite( pin, level ); };
+    inline void delayMicros( unsigned int us ) { delayMicroseconds( us ); };
+    inline uint8_t irqOff() { return transport_irq_off(); };
+    inline void irqRestore( uint8_t state ) { transport_irq_restore( state ); };
+};
+#endif
+
+
+template<uint8_t MOSI_PIN, uint8_t SCK_PIN>
+class SoftSPITransport
+{
+  private:
+    uint8_t _cpol, _cpha;
+
+  public:
+    SoftSPITransport() : _cpol( 0 ), _cpha( 0 ) {};
+
+    inline void begin( uint8_t data_mode, uint8_t )
+    {
+      _cpol = ( data_mode==SPI_MODE2 || data_mode==SPI_MODE3 );
+      _cpha = ( data_mode==SPI_MODE1 || data_mode==SPI_MODE3 );
+      pinMode( MOSI_PIN, OUTPUT );
+      pinMode( SCK_PIN, OUTPUT );
+      digitalWrite( SCK_PIN, _cpol );
+    };
+    inline void beginSelect( uint8_t pin ) { digitalWrite( pin, HIGH ); pinMode( pin, OUTPUT ); };
+
+    /* MSB first.  There's no MISO, so this always returns 0. */
+    uint8_t transfer( uint8_t b )
+    {
+      uint8_t i;
+      for( i = 0; i < 8; i++, b <<= 1 )
+      {
+        if( _cpha ) digitalWrite( SCK_PIN, !_cpol );
+        digitalWrite( MOSI_PIN, ( b & 0x80 ) ? HIGH : LOW );
+        digitalWrite( SCK_PIN, _cpha ? _cpol : !_cpol );
+        if( !_cpha ) digitalWrite( SCK_PIN, _cpol );
+      }
+      return 0;
+    };
+    inline void transferFast( uint8_t b ) { transfer( b ); };
+    inline void write( const uint8_t *data, uint8_t len ) { while( len-- ) transfer( *data++ ); };
+    inline void select( uint8_t pin, uint8_t level ) { digitalWrite( pin, level ); };
+    inline void delayMicros( unsigned int us ) { delayMicroseconds( us ); };
+    inline uint8_t irqOff() { return transport_irq_off(); };
+    inline void irqRestore( uint8_t state ) { transport_irq_restore( state ); };
+};
+
+#endif
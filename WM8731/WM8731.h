@@ -3,7 +3,16 @@
  *
  * NOTE: This library only controls the codec operation.  It doesn't have a data interface!  You need to do that yourself (e.g. with I2S).
  *
- * Requires the Wire library.
+ * Requires the Wire, I2CBus and Transport libraries: #include <Wire.h>, <I2CBus.h> and <TransportI2C.h> first.
+ * The codec is a high-priority client of the shared bus.
+ * For another bus, use WM8731_T<transport> (see TransportI2C.h), e.g. WM8731_T< SoftI2CTransport<2,3> >::begin(...).
+ *
+ * Cost per call (I2C bytes including the address byte; one transaction per set()):
+ *      set(), reset(), setActive(), setInactive()      3 bytes, about 0.3ms at 100kHz
+ *      setInputVolume(), setOutputVolume()             2 transactions, 6 bytes
+ *      begin()                                         10 transactions, 30 bytes; plus 200ms delay the first time
+ * WM8731_T<MockI2CTransport> (TransportMock.h) counts the bus bytes for you (in bus()).
+ * With WM8731_DEBUG defined, each set() also prints a line to Serial, which costs far more than the I2C write.
  *
  * 2013-01-14 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
  */
@@ -12,6 +21,7 @@
 #define __WM8731_H__
  
 #include "Arduino.h"
+#include <TransportI2C.h>
 
 /* The address of the codec is set by the state of the CSB pin */
 
@@ -128,10 +138,17 @@ typedef enum {
  
 #define WM8731_DEBUG
 #define WM8731_NREGISTERS 10
-static unsigned short WM8731_registers[WM8731_NREGISTERS];
+#define WM8731_MAX_HOLD_MICROSEC 500     // cap on one transaction on the shared bus (3 bytes is about 270uS at 100kHz)
 
-class WM8731_class
+template<class I2C_T>
+class WM8731_T
 {
+private:
+    static I2C_T _bus;
+    static unsigned char _initialized;
+    static unsigned char _address;
+    static unsigned short _registers[WM8731_NREGISTERS];
+
 public:
     static void begin( WM8731_csb device_address, unsigned char sampling_flags, unsigned char interface_flags );
     static void reset();
@@ -140,9 +157,168 @@ public:
     static void setInputVolume( unsigned char value ); /* 0 to 63 */
     static void setOutputVolume( unsigned char value ); /* 0 to 31 */
     static void set( unsigned char reg, unsigned short value );
-    static inline unsigned short get( unsigned char reg ) { return WM8731_registers[reg]; };
+    static unsigned char post( unsigned char reg, unsigned short value );
+    static inline unsigned short get( unsigned char reg ) { return _registers[reg]; };
+    static inline I2C_T& bus() { return _bus; };    /* the transport */
 };
 
+template<class I2C_T> I2C_T WM8731_T<I2C_T>::_bus;
+template<class I2C_T> unsigned char WM8731_T<I2C_T>::_initialized = 0;
+template<class I2C_T> unsigned char WM8731_T<I2C_T>::_address = WM8731_DEVICE_ADDRESS_CSB_LOW;
+template<class I2C_T> unsigned short WM8731_T<I2C_T>::_registers[WM8731_NREGISTERS];
+
+
+/*
+ * @brief Initialize the WM8731 codec.
+ * @param[in]   device_address    Either "low" (hex 1A) or "high" (hex 1B), depending whether the CSB pin is wired low or high.
+ * @param[in]   sampling_flags    Combination of flags to define the sample rate etc.  For example WM8731_SAMPLING_RATE(hz48000)
+ * @param[in]   interface_flags   Combination of flags to define the data interface.  For example WM8731_INTERFACE_FORMAT(I2S) | WM8731_INTERFACE_MASTER
+ * @return none.
+ */
+template<class I2C_T>
+void WM8731_T<I2C_T>::begin( WM8731_csb device_address, unsigned char sampling_flags, unsigned char interface_flags )
+{
+    _address = device_address;
+    if( !_initialized )
+    {
+        _initialized = 1;
+        _bus.begin( I2CBUS_PRIORITY_HIGH, WM8731_MAX_HOLD_MICROSEC );
+        delay(200);
+    }
+    
+    // Reset the codec
+    reset();
+       
+    // Set the digital data format
+    set( WM8731_INTERFACE, interface_flags );
+    
+    // Default volumes are all off
+    set( WM8731_LLINEIN,  WM8731_LLINEIN_LINVOL(0) );
+    set( WM8731_RLINEIN,  WM8731_RLINEIN_RINVOL(0) );
+    set( WM8731_LHEADOUT, WM8731_LHEADOUT_LHPVOL(0) );
+    set( WM8731_RHEADOUT, WM8731_RHEADOUT_RHPVOL(0) );
+    set( WM8731_ANALOG,   WM8731_ANALOG_DACSEL );
+    set( WM8731_DIGITAL, 0 );
+    
+    set( WM8731_SAMPLING, sampling_flags );
+
+    // Power on all modules
+    set( WM8731_POWERDOWN, 0 );
+
+    //set( 0x10, 0xa0 );
+}
+
+/*
+ * @brief Reset the codec.  (This is done automatically on 'begin')
+ * @return none.
+ */
+template<class I2C_T>
+void WM8731_T<I2C_T>::reset()
+{
+    set( WM8731_RESET, 0 );
+}               
+
+/*
+ * @brief Makes the codec active.  (This is NOT done automatically on 'begin').
+ * @return none.
+ */
+template<class I2C_T>
+void WM8731_T<I2C_T>::setActive()
+{
+    set( WM8731_CONTROL, WM8731_CONTROL_ACTIVE );
+    //set( 0x12, 1 );
+}
+
+/*
+ * @brief Makes the codec inactive.  (Its functions are powered on still).
+ * @return none.
+ */
+template<class I2C_T>
+void WM8731_T<I2C_T>::setInactive()
+{
+    set( WM8731_CONTROL, 0 );
+}
+
+/*
+ * @brief Sets the input gain on both line-input channels.
+ * @param[in]   value       Volume, 0 to 31
+ * @return none.
+ */
+template<class I2C_T>
+void WM8731_T<I2C_T>::setInputVolume( unsigned char value )
+{
+    unsigned char reg;
+    reg = ( get(WM8731_LLINEIN) & WM8731_LLINEIN_LINVOL_MASK ) | WM8731_LLINEIN_LINVOL(value);
+    set( WM8731_LLINEIN, reg );
+    reg = ( get(WM8731_RLINEIN) & WM8731_RLINEIN_RINVOL_MASK ) | WM8731_RLINEIN_RINVOL(value);
+    set( WM8731_RLINEIN, reg );
+}
+
+/*
+ * @brief Sets the output volume both channels.
+ * @param[in]   value       Volume, 0 to 127
+ * @return none.
+ */
+template<class I2C_T>
+void WM8731_T<I2C_T>::setOutputVolume( unsigned char value )
+{
+    unsigned char reg;
+    reg = ( get(WM8731_LHEADOUT) & WM8731_LHEADOUT_LHPVOL_MASK ) | WM8731_LHEADOUT_LHPVOL(value) /* | WM8731_LHEADOUT_LZCEN */;
+    set( WM8731_LHEADOUT, reg );
+    reg = ( get(WM8731_RHEADOUT) & WM8731_RHEADOUT_RHPVOL_MASK ) | WM8731_RHEADOUT_RHPVOL(value) /* | WM8731_LHEADOUT_RZCEN */;
+    set( WM8731_RHEADOUT, reg );
+}
+
+/*
+ * @brief Sets any parameter.
+ * @param[in]   reg         The register
+ * @param[in]   value       The value to write into the register
+ * @return none.
+ */
+template<class I2C_T>
+void WM8731_T<I2C_T>::set( unsigned char reg, unsigned short value )
+{
+    uint8_t data[2];
+    
+    if( reg < WM8731_NREGISTERS )
+        _registers[reg] = value;
+        
+#ifdef WM8731_DEBUG
+    Serial.print( "WM8731 register 0x" );
+    Serial.print( reg, HEX );
+    Serial.print( " = 0x" );
+    Serial.println( value, HEX );
+#endif
+
+    data[0] = (unsigned char)((reg<<1) | ((value>>8) & 0x1));
+    data[1] = (unsigned char)(value & 0xFF);
+    _bus.write( _address, data, 2 );
+}
+
+/*
+ * @brief Sets any parameter, later: with the shared bus, the write is queued and goes before any lower-priority traffic.
+ *        Safe to call from an interrupt handler on AVR.  (Call I2CBus.service() from your loop to be sure it goes soon.)
+ *        With other transports, it's the same as set().
+ * @param[in]   reg         The register
+ * @param[in]   value       The value to write into the register
+ * @return I2CBUS_OK, or I2CBUS_NO_ROOM if the queue is full.
+ */
+template<class I2C_T>
+unsigned char WM8731_T<I2C_T>::post( unsigned char reg, unsigned short value )
+{
+    uint8_t data[2];
+    
+    if( reg < WM8731_NREGISTERS )
+        _registers[reg] = value;
+    
+    data[0] = (unsigned char)((reg<<1) | ((value>>8) & 0x1));
+    data[1] = (unsigned char)(value & 0xFF);
+    return _bus.post( _address, data, 2 );
+}
+
+
+/* The codec on the shared Wire bus */
+typedef WM8731_T<SharedWireTransport> WM8731_class;
 extern WM8731_class WM8731;
 
 #endif
@@ -0,0 +1,217 @@
+/*
+  bench.cpp  (host simulation)
+  
+  Benchmark of every public API of TLV5618, WM8731 and Nunchuk on the simulated core.
+  For each call it reports the bus bytes, chip-select (pin) edges, blocking delay and virtual time,
+  which are exact and repeatable, and the host CPU time, which is only a rough guide.
+  
+    bench                   print the table
+    bench --write FILE      write the table as a new baseline
+    bench --check FILE      compare with a baseline; fail if anything got worse, or is missing
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "SPI.h"
+#include "MockCore.h"
+#include "MockDevices.h"
+
+#include <I2CBus.h>
+#include <TLV5618.h>
+#include <WM8731.h>
+#include <Nunchuk.h>
+
+#define CPU_REPEAT 2000
+
+struct Result
+{
+  std::string name;
+  unsigned long bus_bytes;
+  unsigned long cs_edges;
+  unsigned long delay_us;
+  unsigned long virtual_us;
+  double cpu_ns;
+};
+
+static std::vector<Result> results;
+
+/* Volatile sink so the compiler keeps the getter calls */
+static volatile long sink;
+
+template<class F>
+static void measure( const char *name, F op )
+{
+  Result r;
+  unsigned long long t0;
+  
+  mock::clearCounters();
+  mock::clearLog();
+  t0 = mock::nowNanos();
+  op();
+  const mock::Counters& c = mock::counters();
+  r.name = name;
+  r.bus_bytes = c.i2c_bytes + c.spi_bytes;
+  r.cs_edges = c.pin_edges;
+  r.delay_us = c.delay_us;
+  r.virtual_us = (unsigned long)( ( mock::nowNanos() - t0 + 500 ) / 1000 );
+  
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for( int i = 0; i < CPU_REPEAT; i++ )
+  {
+    op();
+    if( ( i & 63 )==0 )
+      mock::clearLog();
+  }
+  r.cpu_ns = std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count() / CPU_REPEAT;
+  mock::clearLog();
+  
+  results.push_back( r );
+}
+
+
+static void run()
+{
+  mock::reset();
+  
+  MockWM8731 codec;
+  MockNunchuk chuk;
+  mock::attachI2C( WM8731_DEVICE_ADDRESS_CSB_LOW, &codec );
+  mock::attachI2C( NUNCHUK_TWI_DEVICE_ADDRESS, &chuk );
+  
+  /* TLV5618 */
+  TLV5618 dac( 10 );
+  measure( "TLV5618::begin", [&]() { dac.begin(); } );
+  measure( "TLV5618::select", [&]() { dac.select( 1 ); dac.select( 0 ); } );
+  measure( "TLV5618::write_data_no_cs", [&]() { dac.write_data_no_cs( TLV5618_CMD_WRITE_B_AND_BUFFER, 0x800 ); } );
+  measure( "TLV5618::write_data", [&]() { dac.write_data( TLV5618_CMD_WRITE_B_AND_BUFFER, 0x800 ); } );
+  measure( "TLV5618::write_fast", [&]() { dac.write_fast( TLV5618_CMD_WRITE_B_AND_BUFFER, 0x800 ); } );
+  measure( "TLV5618::write", [&]() { dac.write( 0x123, 0x456 ); } );
+  
+  /* WM8731 */
+  measure( "WM8731::begin", [&]() { WM8731.begin( low, WM8731_SAMPLING_RATE(hz48000), WM8731_INTERFACE_FORMAT(I2S) ); } );
+  measure( "WM8731::reset", [&]() { WM8731.reset(); } );
+  measure( "WM8731::setActive", [&]() { WM8731.setActive(); } );
+  measure( "WM8731::setInactive", [&]() { WM8731.setInactive(); } );
+  measure( "WM8731::setInputVolume", [&]() { WM8731.setInputVolume( 20 ); } );
+  measure( "WM8731::setOutputVolume", [&]() { WM8731.setOutputVolume( 100 ); } );
+  measure( "WM8731::set", [&]() { WM8731.set( WM8731_ANALOG, WM8731_ANALOG_DACSEL ); } );
+  measure( "WM8731::get", [&]() { sink = WM8731.get( WM8731_ANALOG ); } );
+  measure( "WM8731::post+service", [&]() { WM8731.post( WM8731_LHEADOUT, 50 ); I2CBus.service(); } );
+  
+  /* Nunchuk */
+  Nunchuk nc;
+  measure( "Nunchuk::begin", [&]() { nc.begin(); } );
+  measure( "Nunchuk::read", [&]() { sink = nc.read(); } );
+  measure( "Nunchuk::request", [&]() { nc.request(); } );
+  measure( "Nunchuk::fetch", [&]() { sink = nc.fetch(); } );
+  measure( "Nunchuk::isOk", [&]() { sink = nc.isOk(); } );
+  measure( "Nunchuk::getButtonZ", [&]() { sink = nc.getButtonZ(); } );
+  measure( "Nunchuk::getButtonC", [&]() { sink = nc.getButtonC(); } );
+  measure( "Nunchuk::getJoyX", [&]() { sink = nc.getJoyX(); } );
+  measure( "Nunchuk::getJoyY", [&]() { sink = nc.getJoyY(); } );
+  measure( "Nunchuk::getAccelX", [&]() { sink = nc.getAccelX(); } );
+  measure( "Nunchuk::getAccelY", [&]() { sink = nc.getAccelY(); } );
+  measure( "Nunchuk::getAccelZ", [&]() { sink = nc.getAccelZ(); } );
+  measure( "Nunchuk::getAccel", [&]() { sink = (long)nc.getAccel(); } );
+  measure( "Nunchuk::getTiltX", [&]() { sink = (long)nc.getTiltX(); } );
+  measure( "Nunchuk::getTiltY", [&]() { sink = (long)nc.getTiltY(); } );
+  measure( "Nunchuk::getTiltZ", [&]() { sink = (long)nc.getTiltZ(); } );
+  measure( "Nunchuk::getStats", [&]() { sink = nc.getStats().reads_ok + nc.getLatencyAvg(); } );
+}
+
+
+static void print( FILE *f, bool cpu )
+{
+  fprintf( f, "# %-30s %9s %8s %8s %10s%s\n", "api", "bus_bytes", "cs_edges", "delay_us", "virtual_us", cpu ? "     cpu_ns" : "" );
+  for( size_t i = 0; i < results.size(); i++ )
+  {
+    const Result& r = results[i];
+    fprintf( f, "%-32s %9lu %8lu %8lu %10lu", r.name.c_str(), r.bus_bytes, r.cs_edges, r.delay_us, r.virtual_us );
+    if( cpu )
+      fprintf( f, " %10.1f", r.cpu_ns );
+    fprintf( f, "\n" );
+  }
+}
+
+static int check( const char *path )
+{
+  std::map<std::string, Result> base;
+  char line[256], name[128];
+  int failures = 0;
+  FILE *f = fopen( path, "r" );
+  
+  if( !f )
+  {
+    fprintf( stderr, "can't open baseline %s\n", path );
+    return 1;
+  }
+  while( fgets( line, sizeof(line), f ) )
+  {
+    Result r;
+    if( line[0]=='#' )
+      continue;
+    if( sscanf( line, "%127s %lu %lu %lu %lu", name, &r.bus_bytes, &r.cs_edges, &r.delay_us, &r.virtual_us )==5 )
+      base[name] = r;
+  }
+  fclose( f );
+  
+  for( size_t i = 0; i < results.size(); i++ )
+  {
+    const Result& r = results[i];
+    std::map<std::string, Result>::iterator b = base.find( r.name );
+    if( b==base.end() )
+    {
+      printf( "NEW        %s (not in the baseline)\n", r.name.c_str() );
+      failures++;
+      continue;
+    }
+    const Result& o = b->second;
+    if( r.bus_bytes > o.bus_bytes || r.cs_edges > o.cs_edges || r.delay_us > o.delay_us || r.virtual_us > o.virtual_us )
+    {
+      printf( "REGRESSION %s: bytes %lu->%lu edges %lu->%lu delay %lu->%lu virtual %lu->%lu\n", r.name.c_str(),
+              o.bus_bytes, r.bus_bytes, o.cs_edges, r.cs_edges, o.delay_us, r.delay_us, o.virtual_us, r.virtual_us );
+      failures++;
+    }
+    else if( r.bus_bytes < o.bus_bytes || r.cs_edges < o.cs_edges || r.delay_us < o.delay_us || r.virtual_us < o.virtual_us )
+      printf( "IMPROVED   %s (update the baseline)\n", r.name.c_str() );
+    base.erase( b );
+  }
+  for( std::map<std::string, Result>::iterator b = base.begin(); b != base.end(); ++b )
+  {
+    printf( "MISSING    %s (in the baseline, not measured)\n", b->first.c_str() );
+    failures++;
+  }
+  
+  printf( "%d problem(s)\n", failures );
+  return failures ? 1 : 0;
+}
+
+int main( int argc, char **argv )
+{
+  run();
+  print( stdout, true );
+  
+  if( argc==3 && strcmp( argv[1], "--write" )==0 )
+  {
+    FILE *f = fopen( argv[2], "w" );
+    if( !f )
+      return 1;
+    fprintf( f, "# Baseline for host/bench.  Regenerate with: bench --write host/bench/baseline.txt\n" );
+    fprintf( f, "# Bus and time figures are from the simulated core (100kHz I2C, SPI at F_CPU/2).  CPU time isn't compared.\n" );
+    print( f, false );
+    fclose( f );
+    return 0;
+  }
+  if( argc==3 && strcmp( argv[1], "--check" )==0 )
+    return check( argv[2] );
+  return 0;
+}
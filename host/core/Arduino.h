@@ -0,0 +1,89 @@
+/*
+  Arduino.h  (host simulation)
+  
+  Just enough of the Arduino core to build these libraries on a PC, for tests and benchmarks.
+  Time is virtual: micros() only moves when the code delays or uses a bus.  See MockCore.h.
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#ifndef __HOST_ARDUINO_H__
+#define __HOST_ARDUINO_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH            1
+#define LOW             0
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+
+#define LSBFIRST        0
+#define MSBFIRST        1
+
+#define DEC             10
+#define HEX             16
+
+#ifndef F_CPU
+#define F_CPU           16000000UL
+#endif
+
+void pinMode( uint8_t pin, uint8_t mode );
+void digitalWrite( uint8_t pin, uint8_t level );
+int digitalRead( uint8_t pin );
+
+unsigned long millis();
+unsigned long micros();
+void delay( unsigned long ms );
+void delayMicroseconds( unsigned int us );
+
+/* Interrupts: events scheduled with mock::at() wait while these are off */
+void noInterrupts();
+void interrupts();
+#define cli()   noInterrupts()
+#define sei()   interrupts()
+
+/* The AVR status register; only the I bit (0x80), which follows noInterrupts()/interrupts(),
+   so the libraries' SREG save/restore runs here as on AVR */
+class MockSREG
+{
+  public:
+    operator uint8_t() const;
+    MockSREG& operator=( uint8_t value );
+};
+extern MockSREG mock_SREG;
+#define SREG    mock_SREG
+
+/* The AVR TWI bit-rate register; the simulated Wire clock follows it */
+extern volatile uint8_t mock_TWBR;
+#define TWBR    mock_TWBR
+
+
+/* Serial output is discarded */
+class HardwareSerial
+{
+  public:
+    void begin( unsigned long ) {};
+    size_t print( const char * ) { return 0; };
+    size_t print( char ) { return 0; };
+    size_t print( long, int = DEC ) { return 0; };
+    size_t print( unsigned long, int = DEC ) { return 0; };
+    size_t print( int n, int base = DEC ) { return print( (long)n, base ); };
+    size_t print( unsigned int n, int base = DEC ) { return print( (unsigned long)n, base ); };
+    size_t print( unsigned char n, int base = DEC ) { return print( (unsigned long)n, base ); };
+    size_t print( double, int = 2 ) { return 0; };
+    template<class T> size_t println( T v ) { return print( v ); };
+    template<class T> size_t println( T v, int base ) { return print( v, base ); };
+    size_t println() { return 0; };
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,80 @@
+/*
+  MockCore.h  (host simulation)
+  
+  Control and inspection of the simulated Arduino core: virtual time, pins, bus counters,
+  the transaction log, simulated I2C devices (on Wire, or on two pins), and timed "interrupts".
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#ifndef __HOST_MOCKCORE_H__
+#define __HOST_MOCKCORE_H__
+
+#include "Arduino.h"
+
+#define MOCK_TRANSACTION_DATA 32
+
+namespace mock
+{
+  /* Totals since the last clearCounters() */
+  struct Counters
+  {
+    uint32_t i2c_bytes;         /* including address bytes */
+    uint32_t i2c_transactions;
+    uint32_t spi_bytes;
+    uint32_t pin_edges;         /* digitalWrite() level changes, all pins */
+    uint32_t delay_us;          /* delay() and delayMicroseconds() */
+  };
+  
+  /* One bus transaction.  SPI bytes are logged one per transaction, with address 0xFF.
+     Transactions on the I2C pins (attachI2CPins()) are logged too, but not counted in i2c_bytes. */
+  struct Transaction
+  {
+    unsigned long start_us;
+    unsigned long end_us;
+    uint8_t address;
+    bool read;
+    bool ack;
+    uint8_t len;                /* data bytes, not counting the address */
+    uint8_t data[MOCK_TRANSACTION_DATA];
+  };
+  
+  /* A simulated I2C device.  write() returns false to NACK; read() returns the number of bytes it supplies. */
+  class I2CDevice
+  {
+    public:
+      virtual ~I2CDevice() {};
+      virtual bool write( const uint8_t *data, uint8_t len ) = 0;
+      virtual uint8_t read( uint8_t *data, uint8_t len ) = 0;
+      /* Whether it acknowledges its address (not if it's unplugged).  Only the I2C pins look at this. */
+      virtual bool acknowledges() { return true; };
+  };
+  
+  /* Back to time zero, with no devices, no events, and everything cleared */
+  void reset();
+  
+  void clearCounters();
+  const Counters& counters();
+  uint32_t pinEdges( uint8_t pin );
+  uint8_t pinLevel( uint8_t pin );
+  
+  /* Virtual time, in nanoseconds for precision; micros() is this / 1000 */
+  unsigned long long nowNanos();
+  void advanceNanos( unsigned long long ns );
+  
+  void attachI2C( uint8_t address, I2CDevice *device );
+  
+  /* The attached devices also answer on these two pins, as an open-drain bus with pullups (e.g. for SoftI2CTransport).
+     A device pulls SDA low for its ACKs and read data, so digitalRead() of an input sees that.
+     A write goes to the device at the STOP; each byte of it is acknowledged.  No clock stretching. */
+  void attachI2CPins( uint8_t sda, uint8_t scl );
+  
+  void clearLog();
+  size_t logSize();
+  const Transaction& logEntry( size_t i );
+  
+  /* Call fn(ctx) when virtual time reaches at_us (like an interrupt; waits while interrupts are off) */
+  void at( unsigned long at_us, void (*fn)( void *ctx ), void *ctx );
+}
+
+#endif
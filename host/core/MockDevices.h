@@ -0,0 +1,79 @@
+/*
+  MockDevices.h  (host simulation)
+  
+  Simulated I2C devices for the drivers in this repository.  Attach them with mock::attachI2C() (and mock::attachI2CPins()).
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#ifndef __HOST_MOCKDEVICES_H__
+#define __HOST_MOCKDEVICES_H__
+
+#include "MockCore.h"
+
+/* WM8731 codec: 7-bit register address and 9-bit value in two bytes */
+class MockWM8731 : public mock::I2CDevice
+{
+  public:
+    uint16_t registers[16];
+    uint32_t writes;
+    
+    MockWM8731() : writes( 0 ) { memset( registers, 0, sizeof(registers) ); };
+    
+    bool write( const uint8_t *data, uint8_t len )
+    {
+      if( len != 2 )
+        return false;
+      registers[( data[0] >> 1 ) & 0x0F] = ( ( data[0] & 1 ) << 8 ) | data[1];
+      writes++;
+      return true;
+    };
+    uint8_t read( uint8_t *, uint8_t ) { return 0; };
+};
+
+/* Nunchuk: six encoded bytes per read.  Set "connected" false to make reads come up short.
+   A read needs a request (a one-byte write of 0) first; otherwise it returns whatever the register pointer
+   was left at (here 0xFF), and counts an unrequested read. */
+class MockNunchuk : public mock::I2CDevice
+{
+  public:
+    uint8_t data[6];            /* decoded: joyX, joyY, accel X/Y/Z high bits, buttons and low bits */
+    bool connected;
+    uint32_t requests;
+    uint32_t unrequested_reads;
+    bool requested;
+    
+    MockNunchuk() : connected( true ), requests( 0 ), unrequested_reads( 0 ), requested( false )
+    {
+      data[0] = 128; data[1] = 128;
+      data[2] = 128; data[3] = 128; data[4] = 178;
+      data[5] = 0x03;           /* no buttons */
+    };
+    
+    bool acknowledges() { return connected; };
+    
+    bool write( const uint8_t *cmd, uint8_t len )
+    {
+      if( !connected )
+        return false;
+      requested = ( len==1 && cmd[0]==0 );
+      if( requested )
+        requests++;
+      return true;
+    };
+    
+    uint8_t read( uint8_t *out, uint8_t len )
+    {
+      uint8_t i;
+      if( !connected )
+        return 0;
+      if( !requested )
+        unrequested_reads++;
+      for( i = 0; i < len && i < 6; i++ )
+        out[i] = requested ? (uint8_t)( ( data[i] - 0x17 ) ^ 0x17 ) : 0xFF;
+      requested = false;
+      return i;
+    };
+};
+
+#endif
@@ -0,0 +1,41 @@
+/*
+  SPI.h  (host simulation)
+  
+  Bytes take virtual time (8 clocks at F_CPU / divider) and are recorded.
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#ifndef __HOST_SPI_H__
+#define __HOST_SPI_H__
+
+#include "Arduino.h"
+
+/* Same values as the AVR library */
+#define SPI_CLOCK_DIV4   0x00
+#define SPI_CLOCK_DIV16  0x01
+#define SPI_CLOCK_DIV64  0x02
+#define SPI_CLOCK_DIV128 0x03
+#define SPI_CLOCK_DIV2   0x04
+#define SPI_CLOCK_DIV8   0x05
+#define SPI_CLOCK_DIV32  0x06
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPIClass
+{
+  public:
+    void begin();
+    void end() {};
+    void setBitOrder( uint8_t ) {};
+    void setDataMode( uint8_t ) {};
+    void setClockDivider( uint8_t divider );
+    uint8_t transfer( uint8_t b );
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,43 @@
+/*
+  Wire.h  (host simulation)
+  
+  Transactions go to the simulated devices attached with mock::attachI2C(), take virtual time
+  (9 bit times per byte at the clock set by TWBR), and are recorded.
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#ifndef __HOST_WIRE_H__
+#define __HOST_WIRE_H__
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 32
+
+class TwoWire
+{
+  private:
+    uint8_t _address;
+    uint8_t _tx[BUFFER_LENGTH];
+    uint8_t _txlen;
+    uint8_t _rx[BUFFER_LENGTH];
+    uint8_t _rxlen;
+    uint8_t _rxpos;
+    
+  public:
+    TwoWire();
+    void begin();
+    void beginTransmission( uint8_t address );
+    void beginTransmission( int address ) { beginTransmission( (uint8_t)address ); };
+    uint8_t endTransmission( uint8_t sendStop = 1 );
+    size_t write( uint8_t b );
+    size_t write( const uint8_t *data, size_t len );
+    uint8_t requestFrom( uint8_t address, uint8_t quantity );
+    uint8_t requestFrom( int address, int quantity ) { return requestFrom( (uint8_t)address, (uint8_t)quantity ); };
+    int available();
+    int read();
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,569 @@
+/*
+  mock.cpp  (host simulation)
+  
+  The simulated Arduino core behind Arduino.h, Wire.h, SPI.h and MockCore.h.
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#include <vector>
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "SPI.h"
+#include "MockCore.h"
+
+#define MOCK_PINS 64
+
+HardwareSerial Serial;
+TwoWire Wire;
+SPIClass SPI;
+volatile uint8_t mock_TWBR = 72;
+
+namespace
+{
+  struct Event
+  {
+    unsigned long long at_ns;
+    void (*fn)( void *ctx );
+    void *ctx;
+  };
+  
+  unsigned long long now_ns = 0;
+  mock::Counters totals;
+  uint8_t pin_level[MOCK_PINS];
+  uint8_t pin_mode[MOCK_PINS];
+  uint32_t pin_edges[MOCK_PINS];
+  mock::I2CDevice *devices[128];
+  std::vector<mock::Transaction> txlog;
+  std::vector<Event> events;
+  bool irq_enabled = true;
+  bool in_event = false;
+  uint8_t spi_divider = 4;
+  
+  /* A bit-banged I2C bus on two pins (attachI2CPins()), and the attached devices' side of it */
+  enum PinBusState { PINBUS_IDLE, PINBUS_ADDRESS, PINBUS_WRITE, PINBUS_READ, PINBUS_READ_DONE, PINBUS_NACKED };
+  struct PinBus
+  {
+    bool attached;
+    uint8_t sda, scl;
+    bool sda_high, scl_high;    /* as the host leaves them: released (high, by the pullup) or pulled low */
+    bool device_low;            /* a device is pulling SDA low */
+    PinBusState state;
+    uint8_t bits;               /* clocks of this byte so far (counted as SCL rises); the 9th is the ACK */
+    uint8_t shift;
+    bool host_ack;
+    uint8_t address;
+    bool reading;
+    mock::I2CDevice *dev;
+    uint8_t data[MOCK_TRANSACTION_DATA];
+    uint8_t len;                /* bytes written, or read so far */
+    unsigned long long start;
+  } pinbus;
+  
+  /* Run any events that are due (if interrupts are on) */
+  void runEvents()
+  {
+    if( !irq_enabled || in_event )
+      return;
+    in_event = true;
+    for( bool ran = true; ran; )
+    {
+      ran = false;
+      for( size_t i = 0; i < events.size(); i++ )
+      {
+        if( events[i].at_ns <= now_ns )
+        {
+          Event e = events[i];
+          events.erase( events.begin() + i );
+          e.fn( e.ctx );
+          ran = true;
+          break;
+        }
+      }
+    }
+    in_event = false;
+  }
+  
+  /* Move time forward, stopping for any events on the way */
+  void advance( unsigned long long ns )
+  {
+    unsigned long long end = now_ns + ns;
+    for(;;)
+    {
+      unsigned long long next = end;
+      if( irq_enabled && !in_event )
+        for( size_t i = 0; i < events.size(); i++ )
+          if( events[i].at_ns < next )
+            next = events[i].at_ns;
+      if( next > now_ns )
+        now_ns = next;
+      runEvents();
+      if( now_ns >= end )
+        return;
+    }
+  }
+  
+  /* One I2C byte is 9 clocks; the AVR clock is F_CPU / (16 + 2*TWBR) */
+  unsigned long long i2cByteNanos()
+  {
+    unsigned long hz = F_CPU / ( 16 + 2 * (unsigned long)mock_TWBR );
+    return 9000000000ULL / hz;
+  }
+  
+  void record( uint8_t address, bool read, bool ack, const uint8_t *data, uint8_t len, unsigned long long start )
+  {
+    mock::Transaction t;
+    t.start_us = (unsigned long)( start / 1000 );
+    t.end_us = (unsigned long)( now_ns / 1000 );
+    t.address = address;
+    t.read = read;
+    t.ack = ack;
+    t.len = len;
+    memset( t.data, 0, sizeof(t.data) );
+    memcpy( t.data, data, len < MOCK_TRANSACTION_DATA ? len : MOCK_TRANSACTION_DATA );
+    txlog.push_back( t );
+  }
+  
+  /* What the host leaves a pin at: an output driven low pulls the line low, anything else lets it float high */
+  bool hostHigh( uint8_t pin )
+  {
+    return !( pin_mode[pin]==OUTPUT && pin_level[pin]==LOW );
+  }
+  
+  void pinBusFinish()
+  {
+    switch( pinbus.state )
+    {
+      case PINBUS_WRITE:
+        record( pinbus.address, false, pinbus.dev->write( pinbus.data, pinbus.len ), pinbus.data, pinbus.len, pinbus.start );
+        break;
+      case PINBUS_READ:
+      case PINBUS_READ_DONE:
+        record( pinbus.address, true, true, pinbus.data, pinbus.len, pinbus.start );
+        break;
+      case PINBUS_NACKED:
+        record( pinbus.address, pinbus.reading, false, pinbus.data, 0, pinbus.start );
+        break;
+      default:
+        break;
+    }
+    pinbus.state = PINBUS_IDLE;
+    pinbus.device_low = false;
+  }
+  
+  void pinBusStart()
+  {
+    pinBusFinish();       // a repeated start ends the last transaction
+    pinbus.state = PINBUS_ADDRESS;
+    pinbus.bits = 0;
+    pinbus.shift = 0;
+    pinbus.len = 0;
+    pinbus.start = now_ns;
+  }
+  
+  /* A whole byte from the host: acknowledge it (or not) during the 9th clock */
+  void pinBusByte()
+  {
+    if( pinbus.state==PINBUS_ADDRESS )
+    {
+      pinbus.address = pinbus.shift >> 1;
+      pinbus.reading = ( pinbus.shift & 1 );
+      pinbus.dev = devices[pinbus.address];
+      if( !pinbus.dev || !pinbus.dev->acknowledges() )
+      {
+        pinbus.state = PINBUS_NACKED;
+        return;
+      }
+    }
+    else if( pinbus.len < MOCK_TRANSACTION_DATA )
+      pinbus.data[pinbus.len++] = pinbus.shift;
+    pinbus.device_low = true;
+  }
+  
+  /* After the address's ACK: take the bytes to send, or get ready to receive */
+  void pinBusData()
+  {
+    pinbus.len = 0;
+    if( !pinbus.reading )
+    {
+      pinbus.state = PINBUS_WRITE;
+      return;
+    }
+    pinbus.state = PINBUS_READ;
+    memset( pinbus.data, 0xFF, sizeof(pinbus.data) );     // past what the device has, the line floats high
+    pinbus.dev->read( pinbus.data, MOCK_TRANSACTION_DATA );
+    pinbus.device_low = !( pinbus.data[0] & 0x80 );
+  }
+  
+  /* The host reads (or the device samples) while SCL is high; each rising edge is a clock */
+  void pinBusClockHigh()
+  {
+    bool line = pinbus.sda_high && !pinbus.device_low;
+    
+    switch( pinbus.state )
+    {
+      case PINBUS_ADDRESS:
+      case PINBUS_WRITE:
+        if( pinbus.bits < 8 )
+          pinbus.shift = ( pinbus.shift << 1 ) | ( line ? 1 : 0 );
+        pinbus.bits++;
+        break;
+      case PINBUS_READ:
+        if( pinbus.bits==8 )
+          pinbus.host_ack = !line;
+        pinbus.bits++;
+        break;
+      default:
+        break;
+    }
+  }
+  
+  /* SDA only changes while SCL is low */
+  void pinBusClockLow()
+  {
+    switch( pinbus.state )
+    {
+      case PINBUS_ADDRESS:
+      case PINBUS_WRITE:
+        if( pinbus.bits==8 )
+          pinBusByte();
+        else if( pinbus.bits==9 )
+        {
+          pinbus.device_low = false;
+          pinbus.bits = 0;
+          pinbus.shift = 0;
+          if( pinbus.state==PINBUS_ADDRESS )
+            pinBusData();
+        }
+        break;
+      case PINBUS_READ:
+        if( pinbus.bits==0 )
+          break;
+        else if( pinbus.bits < 8 )
+          pinbus.device_low = !( ( pinbus.data[pinbus.len] << pinbus.bits ) & 0x80 );
+        else if( pinbus.bits==8 )
+          pinbus.device_low = false;      // the host's ACK
+        else
+        {
+          pinbus.len++;
+          pinbus.bits = 0;
+          if( pinbus.host_ack && pinbus.len < MOCK_TRANSACTION_DATA )
+            pinbus.device_low = !( pinbus.data[pinbus.len] & 0x80 );
+          else
+            pinbus.state = PINBUS_READ_DONE;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  
+  /* Called when the host changes either pin of the bus */
+  void pinBusUpdate()
+  {
+    bool sda = hostHigh( pinbus.sda ), scl = hostHigh( pinbus.scl );
+    bool sda_was = pinbus.sda_high, scl_was = pinbus.scl_high;
+    
+    pinbus.sda_high = sda;
+    pinbus.scl_high = scl;
+    if( scl && scl_was && sda != sda_was )
+    {
+      // SDA changing while SCL is high: a START (falling) or a STOP (rising)
+      if( sda )
+        pinBusFinish();
+      else
+        pinBusStart();
+    }
+    else if( scl && !scl_was )
+      pinBusClockHigh();
+    else if( !scl && scl_was )
+      pinBusClockLow();
+  }
+  
+  inline bool onPinBus( uint8_t pin )
+  {
+    return pinbus.attached && ( pin==pinbus.sda || pin==pinbus.scl );
+  }
+}
+
+
+/* ----- Arduino core ----- */
+
+void pinMode( uint8_t pin, uint8_t mode )
+{
+  if( pin >= MOCK_PINS )
+    return;
+  pin_mode[pin] = mode;
+  if( onPinBus( pin ) )
+    pinBusUpdate();
+}
+
+void digitalWrite( uint8_t pin, uint8_t level )
+{
+  if( pin >= MOCK_PINS )
+    return;
+  level = level ? HIGH : LOW;
+  if( pin_level[pin] != level )
+  {
+    pin_edges[pin]++;
+    totals.pin_edges++;
+  }
+  pin_level[pin] = level;
+  if( onPinBus( pin ) )
+    pinBusUpdate();
+}
+
+int digitalRead( uint8_t pin )
+{
+  if( pin >= MOCK_PINS )
+    return LOW;
+  // An input floats high (the bus pullups), unless a device on the I2C pins is pulling it low
+  if( pin_mode[pin] != OUTPUT )
+    return ( pinbus.attached && pin==pinbus.sda && pinbus.device_low ) ? LOW : HIGH;
+  return pin_level[pin];
+}
+
+unsigned long micros()
+{
+  return (unsigned long)( now_ns / 1000 );
+}
+
+unsigned long millis()
+{
+  return (unsigned long)( now_ns / 1000000 );
+}
+
+void delay( unsigned long ms )
+{
+  totals.delay_us += ms * 1000;
+  advance( ms * 1000000ULL );
+}
+
+void delayMicroseconds( unsigned int us )
+{
+  totals.delay_us += us;
+  advance( us * 1000ULL );
+}
+
+void noInterrupts()
+{
+  irq_enabled = false;
+}
+
+void interrupts()
+{
+  irq_enabled = true;
+  runEvents();
+}
+
+MockSREG mock_SREG;
+
+MockSREG::operator uint8_t() const
+{
+  return irq_enabled ? 0x80 : 0;
+}
+
+MockSREG& MockSREG::operator=( uint8_t value )
+{
+  if( value & 0x80 )
+    interrupts();
+  else
+    noInterrupts();
+  return *this;
+}
+
+
+/* ----- Wire ----- */
+
+TwoWire::TwoWire() : _address( 0 ), _txlen( 0 ), _rxlen( 0 ), _rxpos( 0 ) {}
+
+void TwoWire::begin()
+{
+  mock_TWBR = 72;   // 100kHz, as on AVR
+}
+
+void TwoWire::beginTransmission( uint8_t address )
+{
+  _address = address;
+  _txlen = 0;
+}
+
+size_t TwoWire::write( uint8_t b )
+{
+  if( _txlen >= BUFFER_LENGTH )
+    return 0;
+  _tx[_txlen++] = b;
+  return 1;
+}
+
+size_t TwoWire::write( const uint8_t *data, size_t len )
+{
+  size_t i;
+  for( i = 0; i < len; i++ )
+    if( !write( data[i] ) )
+      break;
+  return i;
+}
+
+uint8_t TwoWire::endTransmission( uint8_t )
+{
+  unsigned long long start = now_ns;
+  mock::I2CDevice *dev = devices[_address & 0x7F];
+  bool ack = ( dev != 0 );
+  uint8_t sent = ack ? _txlen : 0;
+  
+  totals.i2c_transactions++;
+  totals.i2c_bytes += 1 + sent;
+  advance( ( 1 + sent ) * i2cByteNanos() );
+  if( dev )
+    ack = dev->write( _tx, _txlen );
+  record( _address, false, ack, _tx, sent, start );
+  _txlen = 0;
+  return ack ? 0 : 2;
+}
+
+uint8_t TwoWire::requestFrom( uint8_t address, uint8_t quantity )
+{
+  unsigned long long start = now_ns;
+  mock::I2CDevice *dev = devices[address & 0x7F];
+  
+  if( quantity > BUFFER_LENGTH )
+    quantity = BUFFER_LENGTH;
+  _rxlen = dev ? dev->read( _rx, quantity ) : 0;
+  if( _rxlen > quantity )
+    _rxlen = quantity;
+  _rxpos = 0;
+  
+  totals.i2c_transactions++;
+  totals.i2c_bytes += 1 + _rxlen;
+  advance( ( 1 + _rxlen ) * i2cByteNanos() );
+  record( address, true, dev != 0, _rx, _rxlen, start );
+  return _rxlen;
+}
+
+int TwoWire::available()
+{
+  return _rxlen - _rxpos;
+}
+
+int TwoWire::read()
+{
+  if( _rxpos >= _rxlen )
+    return -1;
+  return _rx[_rxpos++];
+}
+
+
+/* ----- SPI ----- */
+
+void SPIClass::begin()
+{
+  spi_divider = 4;
+}
+
+void SPIClass::setClockDivider( uint8_t divider )
+{
+  static const uint8_t dividers[8] = { 4, 16, 64, 128, 2, 8, 32, 64 };
+  spi_divider = dividers[divider & 7];
+}
+
+uint8_t SPIClass::transfer( uint8_t b )
+{
+  unsigned long long start = now_ns;
+  totals.spi_bytes++;
+  advance( 8ULL * spi_divider * 1000000000ULL / F_CPU );
+  record( 0xFF, false, true, &b, 1, start );
+  return 0;
+}
+
+
+/* ----- Control ----- */
+
+namespace mock
+{
+  void reset()
+  {
+    now_ns = 0;
+    memset( pin_level, 0, sizeof(pin_level) );
+    memset( pin_mode, 0, sizeof(pin_mode) );
+    memset( devices, 0, sizeof(devices) );
+    memset( &pinbus, 0, sizeof(pinbus) );
+    events.clear();
+    irq_enabled = true;
+    mock_TWBR = 72;
+    spi_divider = 4;
+    clearCounters();
+    clearLog();
+  }
+  
+  void clearCounters()
+  {
+    memset( &totals, 0, sizeof(totals) );
+    memset( pin_edges, 0, sizeof(pin_edges) );
+  }
+  
+  const Counters& counters()
+  {
+    return totals;
+  }
+  
+  uint32_t pinEdges( uint8_t pin )
+  {
+    return pin < MOCK_PINS ? pin_edges[pin] : 0;
+  }
+  
+  uint8_t pinLevel( uint8_t pin )
+  {
+    return pin < MOCK_PINS ? pin_level[pin] : 0;
+  }
+  
+  unsigned long long nowNanos()
+  {
+    return now_ns;
+  }
+  
+  void advanceNanos( unsigned long long ns )
+  {
+    advance( ns );
+  }
+  
+  void attachI2C( uint8_t address, I2CDevice *device )
+  {
+    devices[address & 0x7F] = device;
+  }
+  
+  void attachI2CPins( uint8_t sda, uint8_t scl )
+  {
+    memset( &pinbus, 0, sizeof(pinbus) );
+    pinbus.attached = true;
+    pinbus.sda = sda;
+    pinbus.scl = scl;
+    pinbus.sda_high = hostHigh( sda );
+    pinbus.scl_high = hostHigh( scl );
+  }
+  
+  void clearLog()
+  {
+    txlog.clear();
+  }
+  
+  size_t logSize()
+  {
+    return txlog.size();
+  }
+  
+  const Transaction& logEntry( size_t i )
+  {
+    return txlog[i];
+  }
+  
+  void at( unsigned long at_us, void (*fn)( void *ctx ), void *ctx )
+  {
+    Event e;
+    e.at_ns = at_us * 1000ULL;
+    e.fn = fn;
+    e.ctx = ctx;
+    events.push_back( e );
+  }
+}
@@ -0,0 +1,26 @@
+/*
+  check.h  (host tests)
+  
+  Minimal test assertions: CHECK() reports and counts failures; main() returns CHECK_RESULT().
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#ifndef __HOST_CHECK_H__
+#define __HOST_CHECK_H__
+
+#include <stdio.h>
+
+static int check_failures = 0;
+
+#define CHECK(cond) \
+  do { if( !(cond) ) { printf( "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond ); check_failures++; } } while( 0 )
+
+#define CHECK_EQ(a, b) \
+  do { long _a = (long)(a), _b = (long)(b); \
+       if( _a != _b ) { printf( "%s:%d: CHECK failed: %s == %s (%ld != %ld)\n", __FILE__, __LINE__, #a, #b, _a, _b ); check_failures++; } } while( 0 )
+
+#define CHECK_RESULT() \
+  ( printf( check_failures ? "%d check(s) failed\n" : "ok\n", check_failures ), check_failures ? 1 : 0 )
+
+#endif
@@ -0,0 +1,179 @@
+/*
+  i2cbus_test.cpp  (host tests)
+  
+  The shared I2C bus with the WM8731 and Nunchuk on it:
+  - one client's posted and direct writes reach the device in order;
+  - post() from a handler leaves interrupts off;
+  - replaying a mixed workload (continuous Nunchuk polling, codec volume changes posted from "interrupts"),
+    a codec change never waits behind more than one Nunchuk transaction;
+  - the latency statistics keep a valid average long past where the sum would overflow.
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "SPI.h"
+#include "MockCore.h"
+#include "MockDevices.h"
+#include "check.h"
+
+#include <I2CBus.h>
+#include <WM8731.h>
+#include <Nunchuk.h>
+
+#define BYTE_US         90      /* one byte at 100kHz */
+#define CODEC_CLIENT    0       /* the order of begin() below */
+#define NUNCHUK_CLIENT  1
+
+static MockWM8731 codec;
+static MockNunchuk chuk;
+static Nunchuk nc;
+
+
+static void test_post_then_set_order()
+{
+  mock::clearLog();
+  WM8731.post( WM8731_LHEADOUT, 10 );
+  WM8731.set( WM8731_LHEADOUT, 20 );
+  I2CBus.service();
+  
+  CHECK_EQ( mock::logSize(), 2 );
+  CHECK_EQ( mock::logEntry(0).data[0], 0x04 );
+  CHECK_EQ( mock::logEntry(0).data[1], 10 );
+  CHECK_EQ( mock::logEntry(1).data[0], 0x04 );
+  CHECK_EQ( mock::logEntry(1).data[1], 20 );
+  CHECK_EQ( codec.registers[WM8731_LHEADOUT], 20 );
+  CHECK_EQ( WM8731.get( WM8731_LHEADOUT ), 20 );
+}
+
+
+/* In a handler interrupts are off; post() must leave them that way */
+static void test_post_keeps_interrupts_off()
+{
+  noInterrupts();
+  CHECK_EQ( WM8731.post( WM8731_LHEADOUT, 30 ), I2CBUS_OK );
+  CHECK( !( SREG & 0x80 ) );
+  interrupts();
+  
+  CHECK_EQ( WM8731.post( WM8731_LHEADOUT, 31 ), I2CBUS_OK );
+  CHECK( SREG & 0x80 );
+  I2CBus.service();
+  CHECK_EQ( codec.registers[WM8731_LHEADOUT], 31 );
+}
+
+
+/* A volume change from an "interrupt" (e.g. an encoder) */
+struct VolumeEvent
+{
+  unsigned char volume;
+  bool posted;
+};
+
+static void post_volume( void *ctx )
+{
+  VolumeEvent *e = (VolumeEvent *)ctx;
+  e->posted = ( WM8731.post( WM8731_LHEADOUT, WM8731_LHEADOUT_LHPVOL(e->volume) )==I2CBUS_OK )
+           && ( WM8731.post( WM8731_RHEADOUT, WM8731_RHEADOUT_RHPVOL(e->volume) )==I2CBUS_OK );
+}
+
+static void test_mixed_workload()
+{
+  const int nevents = 500;
+  static VolumeEvent events[nevents];
+  unsigned long t = micros();
+  unsigned long seed = 12345;
+  uint32_t codec_writes = codec.writes;
+  int i;
+  
+  // Volume changes at irregular times, 1 to 4ms apart, landing anywhere in the Nunchuk traffic
+  for( i = 0; i < nevents; i++ )
+  {
+    seed = seed * 1103515245UL + 12345;
+    t += 1000 + ( seed >> 8 ) % 3000;
+    events[i].volume = (unsigned char)( i & 0x3F );
+    events[i].posted = false;
+    mock::at( t, post_volume, &events[i] );
+  }
+  
+  I2CBus.resetStats( CODEC_CLIENT );
+  I2CBus.resetStats( NUNCHUK_CLIENT );
+  nc.resetStats();
+  
+  // The sketch's loop: poll as fast as possible
+  while( micros() < t + 2000 )
+  {
+    nc.read();
+    I2CBus.service();
+  }
+  
+  for( i = 0; i < nevents; i++ )
+    CHECK( events[i].posted );
+  CHECK_EQ( codec.writes - codec_writes, 2 * nevents );
+  CHECK_EQ( codec.registers[WM8731_LHEADOUT], events[nevents-1].volume );
+  CHECK_EQ( nc.getStats().reads_short, 0 );
+  
+  const I2CBusStats& cs = I2CBus.getStats( CODEC_CLIENT );
+  const I2CBusStats& ns = I2CBus.getStats( NUNCHUK_CLIENT );
+  printf( "codec:   %lu writes, latency min/avg/max %u/%u/%u us\n",
+          (unsigned long)cs.transactions, cs.latency.min_us, I2CBus.getLatencyAvg( CODEC_CLIENT ), cs.latency.max_us );
+  printf( "nunchuk: %lu transactions, latency min/avg/max %u/%u/%u us\n",
+          (unsigned long)ns.transactions, ns.latency.min_us, I2CBus.getLatencyAvg( NUNCHUK_CLIENT ), ns.latency.max_us );
+  
+  // Worst case for the second of a pair: one Nunchuk read in progress (address + 6 bytes),
+  // then the first codec write, then its own (3 bytes each)
+  CHECK( cs.latency.max_us <= ( 7 + 3 + 3 ) * BYTE_US );
+  CHECK( cs.latency.min_us >= 3 * BYTE_US );
+  CHECK_EQ( cs.errors, 0 );
+  CHECK_EQ( cs.overruns, 0 );
+  CHECK_EQ( ns.overruns, 0 );
+}
+
+
+static void test_latency_stats()
+{
+  LatencyStats l;
+  uint32_t i;
+
+  latency_reset( &l );
+  CHECK_EQ( latency_avg( &l ), 0 );
+  latency_record( &l, 100 );
+  latency_record( &l, 300 );
+  CHECK_EQ( latency_avg( &l ), 200 );
+  CHECK_EQ( l.min_us, 100 );
+  CHECK_EQ( l.max_us, 300 );
+
+  /* Over 0xFFFF counts as 0xFFFF */
+  latency_reset( &l );
+  latency_record( &l, 100000UL );
+  CHECK_EQ( l.max_us, 0xFFFF );
+
+  /* 2^17 records of 0xFFFF would overflow the sum; halving keeps the average */
+  for( i = 0; i < 0x20000UL; i++ )
+    latency_record( &l, 0xFFFF );
+  CHECK_EQ( latency_avg( &l ), 0xFFFF );
+  CHECK( l.count < 0x20000UL );
+  /* and it still moves */
+  for( i = 0; i < 0x20000UL; i++ )
+    latency_record( &l, 1000 );
+  CHECK( latency_avg( &l ) > 1000 );
+  CHECK( latency_avg( &l ) < 0x8000 );
+}
+
+
+int main()
+{
+  mock::reset();
+  mock::attachI2C( WM8731_DEVICE_ADDRESS_CSB_LOW, &codec );
+  mock::attachI2C( NUNCHUK_TWI_DEVICE_ADDRESS, &chuk );
+  
+  WM8731.begin( low, WM8731_SAMPLING_RATE(hz48000), WM8731_INTERFACE_FORMAT(I2S) );
+  nc.begin();
+  
+  test_post_then_set_order();
+  test_post_keeps_interrupts_off();
+  test_mixed_workload();
+  test_latency_stats();
+  
+  return CHECK_RESULT();
+}
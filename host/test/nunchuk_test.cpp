@@ -0,0 +1,126 @@
+/*
+  nunchuk_test.cpp  (host tests)
+
+  Nunchuk recovery on the shared bus:
+  - every read gets a sample that was requested (none comes from the init registers), also after begin();
+  - unplugged: short reads, a re-initialize, then backoffs of 100, 200, ... 3200ms with no reads in between;
+  - plugged back in (during a backoff): it re-initializes, then reads good data.
+
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "SPI.h"
+#include "MockCore.h"
+#include "MockDevices.h"
+#include "check.h"
+
+#include <I2CBus.h>
+#include <Nunchuk.h>
+
+static MockNunchuk chuk;
+static Nunchuk nc;
+
+
+/* read() once a millisecond while it's backing off.  Returns the first other result; ms is when that read started. */
+static uint8_t read_after_backoff( unsigned long *ms )
+{
+  unsigned long start = millis();
+  uint8_t rc;
+
+  for( ;; )
+  {
+    *ms = millis() - start;
+    if( ( rc = nc.read() )!=NUNCHUK_READ_BACKOFF )
+      return rc;
+    mock::advanceNanos( 1000000ULL );
+  }
+}
+
+
+static void test_first_read()
+{
+  CHECK_EQ( nc.read(), NUNCHUK_READ_OK );
+  CHECK_EQ( nc.read(), NUNCHUK_READ_OK );
+  CHECK_EQ( chuk.unrequested_reads, 0 );
+  CHECK_EQ( nc.getJoyX(), 1 );
+}
+
+
+static void test_unplugged()
+{
+  const unsigned long backoff[] = { 100, 200, 400, 800, 1600, 3200, 3200 };
+  unsigned long ms;
+  uint8_t i;
+
+  nc.resetStats();
+  chuk.connected = false;
+  for( i = 1; i < NUNCHUK_REINIT_FAILURES; i++ )
+    CHECK_EQ( nc.read(), NUNCHUK_READ_SHORT );
+  CHECK_EQ( nc.read(), NUNCHUK_READ_REINIT );
+  CHECK( !nc.isOk() );
+
+  /* Each re-initialize isn't acknowledged, so after each backoff there's another (and no read) */
+  for( i = 0; i < sizeof(backoff)/sizeof(backoff[0]); i++ )
+  {
+    CHECK_EQ( read_after_backoff( &ms ), NUNCHUK_READ_REINIT );
+    CHECK_EQ( ms, backoff[i] );
+  }
+  CHECK_EQ( nc.getStats().reinits, 1 + sizeof(backoff)/sizeof(backoff[0]) );
+  CHECK_EQ( nc.getStats().reads_short, NUNCHUK_REINIT_FAILURES );
+  CHECK_EQ( nc.getJoyX(), 1 );      // previous values kept
+
+  /* Plugged back in during a backoff: re-initialized, then good data */
+  mock::advanceNanos( 1000000000ULL );
+  chuk.connected = true;
+  chuk.data[0] = 200;
+  CHECK_EQ( read_after_backoff( &ms ), NUNCHUK_READ_REINIT );
+  CHECK_EQ( ms, 3200 - 1000 );
+  CHECK_EQ( read_after_backoff( &ms ), NUNCHUK_READ_OK );
+  CHECK_EQ( ms, 3200 );
+  CHECK( nc.isOk() );
+  CHECK_EQ( nc.getJoyX(), 200 - 127 );
+  CHECK_EQ( nc.getStats().consecutive_failures, 0 );
+  CHECK_EQ( chuk.unrequested_reads, 0 );
+
+  /* And no more backoff */
+  CHECK_EQ( nc.read(), NUNCHUK_READ_OK );
+}
+
+
+static void test_replugged_quickly()
+{
+  unsigned long ms;
+  uint8_t i;
+
+  /* The backoff starts again from the shortest */
+  chuk.connected = false;
+  for( i = 1; i < NUNCHUK_REINIT_FAILURES; i++ )
+    nc.read();
+  CHECK_EQ( nc.read(), NUNCHUK_READ_REINIT );
+  chuk.connected = true;
+  chuk.data[0] = 50;
+  CHECK_EQ( read_after_backoff( &ms ), NUNCHUK_READ_REINIT );
+  CHECK_EQ( ms, 100 );
+  CHECK_EQ( read_after_backoff( &ms ), NUNCHUK_READ_OK );
+  CHECK_EQ( ms, 200 );
+  CHECK_EQ( nc.getJoyX(), 50 - 127 );
+  CHECK_EQ( chuk.unrequested_reads, 0 );
+}
+
+
+int main()
+{
+  mock::reset();
+  mock::attachI2C( NUNCHUK_TWI_DEVICE_ADDRESS, &chuk );
+  chuk.data[0] = 128;
+
+  nc.begin();
+
+  test_first_read();
+  test_unplugged();
+  test_replugged_quickly();
+
+  return CHECK_RESULT();
+}
@@ -0,0 +1,197 @@
+/*
+  nunchukdac_test.cpp  (host tests)
+  
+  The Nunchuk to TLV5618 pipeline: integer mapping (linear, and a curve that rises then falls), DAC output,
+  the acquire time after request(), the end-to-end latency at 400kHz and 100kHz,
+  and outputs held (no DAC write) while the Nunchuk is unplugged.
+  
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#include <stdlib.h>
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "SPI.h"
+#include "MockCore.h"
+#include "MockDevices.h"
+#include "check.h"
+
+#include <I2CBus.h>
+#include <TLV5618.h>
+#include <Nunchuk.h>
+#include <NunchukDAC.h>
+
+static MockNunchuk chuk;
+static Nunchuk nc;
+static TLV5618 dac( 10 );
+static NunchukDAC pipeline( nc, dac );
+static NunchukDAC_curve linear;
+static NunchukDAC_curve peak;       /* -40 to 120: up to 4000 at 40, then back down */
+
+
+/* Run for a while; return the shortest gap between the end of a request() and the next fetch() */
+static unsigned long run( unsigned long duration_us )
+{
+  unsigned long end = micros() + duration_us;
+  unsigned long request_end = 0, min_gap = 0xFFFFFFFFUL;
+  size_t i;
+  
+  mock::clearLog();
+  while( micros() < end )
+  {
+    if( !pipeline.poll() )
+      mock::advanceNanos( 5000 );     // the rest of the sketch's loop
+  }
+  
+  for( i = 0; i < mock::logSize(); i++ )
+  {
+    const mock::Transaction& t = mock::logEntry( i );
+    if( t.address != NUNCHUK_TWI_DEVICE_ADDRESS )
+      continue;
+    if( !t.read && t.len==1 )
+      request_end = t.end_us;
+    else if( t.read && request_end )
+    {
+      if( t.start_us - request_end < min_gap )
+        min_gap = t.start_us - request_end;
+      request_end = 0;
+    }
+  }
+  return min_gap;
+}
+
+static void test_mapping()
+{
+  // Accel X = 152*4 + 3 - 511 = 100; accel Y = 128*4 - 511 = 1
+  chuk.data[2] = 152;
+  chuk.data[3] = 128;
+  chuk.data[5] = 0x03 | 0x0C;
+  run( 10000 );
+  
+  CHECK( abs( (int)pipeline.getOutput( NUNCHUKDAC_CHANNEL_A ) - 4095 * 300 / 400 ) <= 2 );
+  CHECK( abs( (int)pipeline.getOutput( NUNCHUKDAC_CHANNEL_B ) - 4095 * 201 / 400 ) <= 2 );
+  
+  // The last SPI bytes are the DAC write of both channels
+  size_t n = mock::logSize();
+  CHECK( n >= 4 );
+  uint16_t a = ( ( mock::logEntry( n-4 ).data[0] & 0x0F ) << 8 ) | mock::logEntry( n-3 ).data[0];
+  uint16_t b = ( ( mock::logEntry( n-2 ).data[0] & 0x0F ) << 8 ) | mock::logEntry( n-1 ).data[0];
+  CHECK_EQ( a, pipeline.getOutput( NUNCHUKDAC_CHANNEL_A ) );
+  CHECK_EQ( b, pipeline.getOutput( NUNCHUKDAC_CHANNEL_B ) );
+}
+
+static void test_curve()
+{
+  uint8_t i;
+  
+  peak.in_min = -40;
+  peak.in_max = 120;
+  for( i = 0; i < NUNCHUKDAC_CURVE_POINTS; i++ )
+    peak.points[i] = ( i <= 8 ? i : 16 - i ) * 500;
+  pipeline.setSource( NUNCHUKDAC_CHANNEL_A, NUNCHUKDAC_JOY_X, &peak );
+  pipeline.setSource( NUNCHUKDAC_CHANNEL_B, NUNCHUKDAC_JOY_Y, &peak );
+  
+  // Half way along a rising step (500 to 1000) and a falling one (3500 to 3000)
+  chuk.data[0] = 127 - 25;
+  chuk.data[1] = 127 + 55;
+  run( 10000 );
+  CHECK( abs( (int)pipeline.getOutput( NUNCHUKDAC_CHANNEL_A ) - 750 ) <= 4 );
+  CHECK( abs( (int)pipeline.getOutput( NUNCHUKDAC_CHANNEL_B ) - 3250 ) <= 4 );
+  
+  // The peak, and clamped past each end
+  chuk.data[0] = 127 + 40;
+  chuk.data[1] = 0;
+  run( 10000 );
+  CHECK( abs( (int)pipeline.getOutput( NUNCHUKDAC_CHANNEL_A ) - 4000 ) <= 4 );
+  CHECK_EQ( pipeline.getOutput( NUNCHUKDAC_CHANNEL_B ), 0 );
+  chuk.data[1] = 255;
+  run( 10000 );
+  CHECK_EQ( pipeline.getOutput( NUNCHUKDAC_CHANNEL_B ), 0 );
+  
+  // No curve: that channel outputs 0
+  pipeline.setSource( NUNCHUKDAC_CHANNEL_A, NUNCHUKDAC_JOY_X, 0 );
+  run( 10000 );
+  CHECK_EQ( pipeline.getOutput( NUNCHUKDAC_CHANNEL_A ), 0 );
+  
+  pipeline.setSource( NUNCHUKDAC_CHANNEL_A, NUNCHUKDAC_ACCEL_X, &linear );
+  pipeline.setSource( NUNCHUKDAC_CHANNEL_B, NUNCHUKDAC_ACCEL_Y, &linear );
+}
+
+static void test_latency( const char *label, unsigned long max_latency_us )
+{
+  unsigned long gap;
+  
+  pipeline.resetStats();
+  gap = run( 200000 );
+  
+  const NunchukDAC_stats& st = pipeline.getStats();
+  printf( "%s: %lu periods, latency min/avg/max %u/%u/%u us, jitter %u us, acquire gap %lu us\n", label,
+          (unsigned long)st.periods, st.latency.min_us, pipeline.getLatencyAvg(), st.latency.max_us, st.jitter_max_us, gap );
+  
+  CHECK( st.periods >= 99 );
+  CHECK_EQ( st.missed, 0 );
+  CHECK_EQ( st.sensor_errors, 0 );
+  CHECK( st.latency.max_us <= max_latency_us );
+  CHECK( st.jitter_max_us <= 10 );
+  CHECK( gap >= NUNCHUKDAC_ACQUIRE_MICROSEC );
+}
+
+static void test_unplugged()
+{
+  uint16_t a, b;
+  uint32_t periods;
+  
+  pipeline.resetStats();
+  run( 10000 );
+  a = pipeline.getOutput( NUNCHUKDAC_CHANNEL_A );
+  b = pipeline.getOutput( NUNCHUKDAC_CHANNEL_B );
+  periods = pipeline.getStats().periods;
+  
+  // Every period is a sensor error (but for the few skipped by the re-initialize's 7ms of delay());
+  // the outputs and the DAC are left alone
+  chuk.connected = false;
+  chuk.data[2] = 100;
+  mock::clearCounters();
+  run( 50000 );
+  CHECK( pipeline.getStats().sensor_errors >= 20 );
+  CHECK_EQ( pipeline.getStats().periods, periods );
+  CHECK_EQ( pipeline.getOutput( NUNCHUKDAC_CHANNEL_A ), a );
+  CHECK_EQ( pipeline.getOutput( NUNCHUKDAC_CHANNEL_B ), b );
+  CHECK_EQ( mock::counters().spi_bytes, 0 );
+  
+  // Plugged back in: running again after the Nunchuk's backoffs (100ms, then 200ms after the re-initialize)
+  chuk.connected = true;
+  run( 400000 );
+  CHECK( pipeline.getStats().periods > periods );
+  CHECK( pipeline.getOutput( NUNCHUKDAC_CHANNEL_A ) < a );
+}
+
+
+int main()
+{
+  mock::reset();
+  mock::attachI2C( NUNCHUK_TWI_DEVICE_ADDRESS, &chuk );
+  
+  I2CBus.begin( 400000 );
+  nc.begin();
+  dac.begin();
+  NunchukDAC::linearCurve( &linear, -200, 200 );
+  pipeline.setSource( NUNCHUKDAC_CHANNEL_A, NUNCHUKDAC_ACCEL_X, &linear );
+  pipeline.setSource( NUNCHUKDAC_CHANNEL_B, NUNCHUKDAC_ACCEL_Y, &linear );
+  pipeline.begin( 2000 );
+  
+  test_mapping();
+  test_curve();
+  
+  // 9 bytes at 22.5us, 300us acquire, DAC write: about 0.5ms
+  test_latency( "400kHz", 550 );
+  
+  // The same bus at 100kHz (as if I2CBus.begin() had the default): 9 bytes at 90us; over 1ms
+  TWBR = 72;
+  test_latency( "100kHz", 1150 );
+  
+  test_unplugged();
+  
+  return CHECK_RESULT();
+}
@@ -0,0 +1,117 @@
+/*
+  transport_mock_test.cpp  (host tests)
+
+  The recording transports on their own.  Built without the simulated core, to show TransportMock.h needs none:
+  - MockI2CTransport logs the bytes read as well as written;
+  - MockSPITransport counts chip-select edges from the pin's idle level, also after clear().
+
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#include <TransportMock.h>
+#include "check.h"
+
+
+static void test_i2c_log()
+{
+  MockI2CTransport bus;
+  const uint8_t cmd[2] = { 0x40, 0x00 };
+  uint8_t data[4];
+
+  bus.reply[0] = 0x11;
+  bus.reply[1] = 0x22;
+  bus.reply[2] = 0x33;
+  bus.reply_len = 3;
+
+  CHECK_EQ( bus.write( 0x52, cmd, 2 ), I2CBUS_OK );
+  CHECK_EQ( bus.read( 0x52, data, 3 ), I2CBUS_OK );
+  CHECK_EQ( data[2], 0x33 );
+  CHECK_EQ( bus.transactions, 2 );
+  CHECK_EQ( bus.bytes, 7 );
+
+  const uint8_t expected[7] = { 0xA4, 0x40, 0x00, 0xA5, 0x11, 0x22, 0x33 };
+  for( uint8_t i = 0; i < 7; i++ )
+    CHECK_EQ( bus.log[i], expected[i] );
+
+  /* Short read: logs the bytes that did arrive */
+  CHECK_EQ( bus.read( 0x52, data, 4 ), I2CBUS_SHORT );
+  CHECK_EQ( bus.bytes, 11 );
+  CHECK_EQ( bus.log[7], 0xA5 );
+  CHECK_EQ( bus.log[10], 0x33 );
+
+  /* The byte count goes on past the end of the log */
+  bus.clear();
+  for( uint8_t i = 0; i < 40; i++ )
+    bus.write( 0x1a, cmd, 2 );
+  CHECK_EQ( bus.bytes, 120 );
+  CHECK_EQ( bus.log[TRANSPORT_MOCK_LOG_SIZE-1], 0x1a << 1 );     // 3 bytes a write: the 22nd address byte
+}
+
+
+static void test_spi_edges()
+{
+  MockSPITransport spi;
+
+  /* Setting the idle level isn't an edge; selecting the level it's already at isn't either */
+  spi.beginSelect( 10 );
+  CHECK_EQ( spi.select_edges, 0 );
+  CHECK_EQ( spi.selectLevel( 10 ), 1 );
+  spi.select( 10, 1 );
+  CHECK_EQ( spi.select_edges, 0 );
+  spi.select( 10, 0 );
+  spi.select( 10, 1 );
+  CHECK_EQ( spi.select_edges, 2 );
+
+  /* clear() keeps the levels, so the next select counts one edge, not two */
+  spi.clear();
+  spi.select( 10, 0 );
+  CHECK_EQ( spi.select_edges, 1 );
+  spi.select( 10, 1 );
+  CHECK_EQ( spi.select_edges, 2 );
+
+  /* Each pin on its own; a pin that was never set up starts low */
+  spi.clear();
+  spi.select( 9, 0 );
+  CHECK_EQ( spi.select_edges, 0 );
+  spi.select( 9, 1 );
+  CHECK_EQ( spi.select_edges, 1 );
+  CHECK_EQ( spi.selectLevel( 10 ), 1 );
+
+  /* Pins past the tracked range count every select() */
+  spi.clear();
+  spi.select( TRANSPORT_MOCK_PINS, 1 );
+  spi.select( TRANSPORT_MOCK_PINS, 1 );
+  CHECK_EQ( spi.select_edges, 2 );
+}
+
+
+static void test_spi_bytes()
+{
+  MockSPITransport spi;
+  const uint8_t frame[3] = { 0x12, 0x34, 0x56 };
+  uint8_t irq;
+
+  spi.transfer( 0xA0 );
+  spi.transferFast( 0xA1 );
+  spi.write( frame, 3 );
+  spi.delayMicros( 7 );
+  irq = spi.irqOff();
+  spi.irqRestore( irq );
+
+  CHECK_EQ( spi.bytes, 5 );
+  CHECK_EQ( spi.log[0], 0xA0 );
+  CHECK_EQ( spi.log[1], 0xA1 );
+  CHECK_EQ( spi.log[4], 0x56 );
+  CHECK_EQ( spi.delay_us, 7 );
+  CHECK_EQ( spi.irq_sections, 1 );
+}
+
+
+int main()
+{
+  test_i2c_log();
+  test_spi_edges();
+  test_spi_bytes();
+
+  return CHECK_RESULT();
+}
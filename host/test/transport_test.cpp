@@ -0,0 +1,292 @@
+/*
+  transport_test.cpp  (host tests)
+
+  The drivers on the other transports:
+  - on the recording transports, each call puts the same bytes, !CS edges and delays as the baseline
+    for the hardware transports (host/bench/baseline.txt), and touches no real pins or Wire;
+  - write_fast() leaves interrupts as they were (SREG save/restore in the transport);
+  - on the bit-banged SPI transport, the DAC frames come out on the pins;
+  - the bit-banged I2C transport talks to the simulated Nunchuk and codec on two pins: ACKs, NACKs and read data;
+  - the Nunchuk-to-DAC pipeline runs on the recording transports too (NunchukDAC_T).
+
+  2026-10-18 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
+*/
+
+#include <stdlib.h>
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "SPI.h"
+#include "MockCore.h"
+#include "MockDevices.h"
+#include "check.h"
+
+#include <I2CBus.h>
+#include <TransportI2C.h>
+#include <TransportMock.h>
+#include <TLV5618.h>
+#include <WM8731.h>
+#include <Nunchuk.h>
+#include <NunchukDAC.h>
+
+
+static inline uint8_t nunchuk_encode( uint8_t x ) { return (uint8_t)( ( x - 0x17 ) ^ 0x17 ); }
+
+
+static void test_tlv5618_mock()
+{
+  TLV5618_T<MockSPITransport> dac( 10 );
+
+  mock::clearCounters();
+  dac.begin();
+  CHECK_EQ( dac.spi.select_edges, 0 );
+  CHECK_EQ( dac.spi.selectLevel( 10 ), 1 );
+
+  dac.spi.clear();
+  dac.write( 0x123, 0x456 );
+  CHECK_EQ( dac.spi.bytes, 4 );
+  CHECK_EQ( dac.spi.select_edges, 4 );
+  CHECK_EQ( dac.spi.delay_us, 5 );
+  CHECK_EQ( dac.spi.log[0], 0x11 );     // buffer A, high bits
+  CHECK_EQ( dac.spi.log[1], 0x23 );
+  CHECK_EQ( dac.spi.log[2], 0x84 );     // channel B and update
+  CHECK_EQ( dac.spi.log[3], 0x56 );
+  CHECK_EQ( dac.spi.selectLevel( 10 ), 1 );
+
+  dac.spi.clear();
+  dac.write_data( TLV5618_CMD_WRITE_B_AND_BUFFER, 0xABC );
+  CHECK_EQ( dac.spi.bytes, 2 );
+  CHECK_EQ( dac.spi.select_edges, 2 );
+  CHECK_EQ( dac.spi.delay_us, 2 );
+
+  dac.spi.clear();
+  dac.write_fast( TLV5618_CMD_WRITE_B_AND_BUFFER, 0xABC );
+  CHECK_EQ( dac.spi.bytes, 2 );
+  CHECK_EQ( dac.spi.select_edges, 2 );
+  CHECK_EQ( dac.spi.delay_us, 0 );
+  CHECK_EQ( dac.spi.irq_sections, 1 );
+  CHECK_EQ( dac.spi.log[0], 0x0A );
+  CHECK_EQ( dac.spi.log[1], 0xBC );
+
+  /* None of that reached the simulated pins or SPI */
+  CHECK_EQ( mock::counters().pin_edges, 0 );
+  CHECK_EQ( mock::counters().spi_bytes, 0 );
+}
+
+
+static void test_write_fast_interrupts()
+{
+  TLV5618 dac( 10 );
+  dac.begin();
+
+  dac.write_fast( TLV5618_CMD_WRITE_B_AND_BUFFER, 0x100 );
+  CHECK( SREG & 0x80 );
+
+  /* Called with interrupts already off (e.g. from a handler): they stay off */
+  noInterrupts();
+  dac.write_fast( TLV5618_CMD_WRITE_B_AND_BUFFER, 0x200 );
+  CHECK( !( SREG & 0x80 ) );
+  interrupts();
+}
+
+
+static void test_nunchuk_mock()
+{
+  Nunchuk_T<MockI2CTransport> nc;
+  const uint8_t sample[6] = { 10, 250, 128, 128, 178, 0x02 };   // button Z pressed
+  uint8_t i;
+
+  mock::clearCounters();
+  nc.begin();
+  CHECK_EQ( nc.bus.transactions, 7 );     // init, then a request
+  CHECK_EQ( nc.bus.bytes, 33 );
+
+  for( i = 0; i < 6; i++ )
+    nc.bus.reply[i] = nunchuk_encode( sample[i] );
+  nc.bus.reply_len = 6;
+
+  nc.bus.clear();
+  CHECK_EQ( nc.read(), NUNCHUK_READ_OK );
+  CHECK_EQ( nc.bus.transactions, 2 );
+  CHECK_EQ( nc.bus.bytes, 9 );
+  CHECK_EQ( nc.bus.log[0], ( NUNCHUK_TWI_DEVICE_ADDRESS << 1 ) | 1 );
+  for( i = 0; i < 6; i++ )
+    CHECK_EQ( nc.bus.log[1+i], nunchuk_encode( sample[i] ) );
+  CHECK_EQ( nc.bus.log[7], NUNCHUK_TWI_DEVICE_ADDRESS << 1 );
+  CHECK_EQ( nc.bus.log[8], NUNCHUK_TWI_CMD_ZERO );
+  CHECK_EQ( nc.getJoyX(), 10 - 127 );
+  CHECK_EQ( nc.getJoyY(), 250 - 127 );
+  CHECK_EQ( nc.getButtonZ(), 1 );
+  CHECK_EQ( nc.getButtonC(), 0 );
+
+  /* Short read: previous values kept */
+  nc.bus.reply_len = 3;
+  CHECK_EQ( nc.read(), NUNCHUK_READ_SHORT );
+  CHECK_EQ( nc.getJoyX(), 10 - 127 );
+  CHECK_EQ( nc.getStats().reads_short, 1 );
+
+  CHECK_EQ( mock::counters().i2c_bytes, 0 );
+}
+
+
+static void test_wm8731_mock()
+{
+  typedef WM8731_T<MockI2CTransport> Codec;
+
+  mock::clearCounters();
+  Codec::begin( low, WM8731_SAMPLING_RATE(hz48000), WM8731_INTERFACE_FORMAT(I2S) );
+  CHECK_EQ( Codec::bus().transactions, 10 );
+  CHECK_EQ( Codec::bus().bytes, 30 );
+
+  Codec::bus().clear();
+  Codec::set( WM8731_LHEADOUT, 0x179 );
+  CHECK_EQ( Codec::bus().bytes, 3 );
+  CHECK_EQ( Codec::bus().log[0], WM8731_DEVICE_ADDRESS_CSB_LOW << 1 );
+  CHECK_EQ( Codec::bus().log[1], ( WM8731_LHEADOUT << 1 ) | 1 );
+  CHECK_EQ( Codec::bus().log[2], 0x79 );
+  CHECK_EQ( Codec::get( WM8731_LHEADOUT ), 0x179 );
+
+  CHECK_EQ( mock::counters().i2c_bytes, 0 );
+}
+
+
+static void test_tlv5618_soft_spi()
+{
+  TLV5618_T< SoftSPITransport<11,13> > dac( 10 );
+
+  dac.begin();
+  mock::clearCounters();
+  dac.write_data( TLV5618_CMD_WRITE_B_AND_BUFFER, 0xFFF );
+  CHECK_EQ( mock::pinEdges( 10 ), 2 );
+  CHECK_EQ( mock::pinLevel( 10 ), HIGH );
+  CHECK_EQ( mock::pinEdges( 13 ), 32 );     // mode 3: two clock edges a bit
+  CHECK_EQ( mock::pinLevel( 13 ), HIGH );   // idles high
+  CHECK_EQ( mock::counters().spi_bytes, 0 );
+}
+
+
+static void test_soft_i2c()
+{
+  typedef SoftI2CTransport<2,3> SoftBus;
+  SoftBus bus;
+  MockNunchuk chuk;
+  MockWM8731 codec;
+  const uint8_t reg[2] = { ( WM8731_LHEADOUT << 1 ) | 1, 0x79 };
+  const uint8_t zero = NUNCHUK_TWI_CMD_ZERO;
+  uint8_t data[6];
+  uint8_t i;
+  
+  mock::attachI2C( NUNCHUK_TWI_DEVICE_ADDRESS, &chuk );
+  mock::attachI2C( WM8731_DEVICE_ADDRESS_CSB_LOW, &codec );
+  mock::attachI2CPins( 2, 3 );
+  mock::clearCounters();
+  mock::clearLog();
+  bus.begin( I2CBUS_PRIORITY_LOW, 0 );
+  
+  /* A write: every byte acknowledged, delivered at the STOP; 3 bytes of 9 clocks at 10us */
+  CHECK_EQ( bus.write( WM8731_DEVICE_ADDRESS_CSB_LOW, reg, 2 ), I2CBUS_OK );
+  CHECK_EQ( codec.writes, 1 );
+  CHECK_EQ( codec.registers[WM8731_LHEADOUT], 0x179 );
+  CHECK_EQ( mock::logSize(), 1 );
+  CHECK( mock::logEntry( 0 ).ack );
+  CHECK_EQ( mock::logEntry( 0 ).len, 2 );
+  CHECK( mock::logEntry( 0 ).end_us - mock::logEntry( 0 ).start_us >= 3 * 9 * 10 );
+  
+  /* No device at the address, or one that's unplugged: NACK */
+  CHECK_EQ( bus.write( 0x30, reg, 2 ), I2CBUS_NACK );
+  chuk.connected = false;
+  CHECK_EQ( bus.write( NUNCHUK_TWI_DEVICE_ADDRESS, &zero, 1 ), I2CBUS_NACK );
+  CHECK_EQ( bus.read( NUNCHUK_TWI_DEVICE_ADDRESS, data, 6 ), I2CBUS_SHORT );
+  chuk.connected = true;
+  
+  /* A request, then the six bytes read back bit by bit */
+  chuk.data[0] = 0x5A;
+  chuk.data[5] = 0x81;
+  CHECK_EQ( bus.write( NUNCHUK_TWI_DEVICE_ADDRESS, &zero, 1 ), I2CBUS_OK );
+  CHECK_EQ( chuk.requests, 1 );
+  CHECK_EQ( bus.read( NUNCHUK_TWI_DEVICE_ADDRESS, data, 6 ), I2CBUS_OK );
+  for( i = 0; i < 6; i++ )
+    CHECK_EQ( data[i], nunchuk_encode( chuk.data[i] ) );
+  CHECK_EQ( chuk.unrequested_reads, 0 );
+  CHECK( mock::logEntry( mock::logSize()-1 ).read );
+  CHECK_EQ( mock::logEntry( mock::logSize()-1 ).len, 6 );
+  
+  /* The drivers on the same pins */
+  Nunchuk_T<SoftBus> nc;
+  nc.begin();
+  CHECK_EQ( nc.read(), NUNCHUK_READ_OK );
+  CHECK_EQ( nc.getJoyX(), 0x5A - 127 );
+  CHECK_EQ( chuk.unrequested_reads, 0 );
+  
+  typedef WM8731_T<SoftBus> Codec;
+  codec.writes = 0;
+  Codec::begin( low, WM8731_SAMPLING_RATE(hz48000), WM8731_INTERFACE_FORMAT(I2S) );
+  CHECK_EQ( codec.writes, 10 );
+  Codec::set( WM8731_LHEADOUT, 0x150 );
+  CHECK_EQ( codec.registers[WM8731_LHEADOUT], 0x150 );
+  
+  /* None of it through Wire */
+  CHECK_EQ( mock::counters().i2c_bytes, 0 );
+  
+  mock::attachI2C( NUNCHUK_TWI_DEVICE_ADDRESS, 0 );
+  mock::attachI2C( WM8731_DEVICE_ADDRESS_CSB_LOW, 0 );
+}
+
+
+static void test_nunchukdac_mock()
+{
+  typedef Nunchuk_T<MockI2CTransport> RecordedNunchuk;
+  typedef TLV5618_T<MockSPITransport> RecordedDAC;
+  RecordedNunchuk nc;
+  RecordedDAC dac( 10 );
+  NunchukDAC_T<RecordedNunchuk, RecordedDAC> pipeline( nc, dac );
+  NunchukDAC_curve linear;
+  const uint8_t sample[6] = { 128 + 100, 128, 128, 128, 178, 0x03 };
+  uint8_t i;
+  
+  mock::clearCounters();
+  nc.begin();
+  dac.begin();
+  for( i = 0; i < 6; i++ )
+    nc.bus.reply[i] = nunchuk_encode( sample[i] );
+  nc.bus.reply_len = 6;
+  
+  NunchukDAC_T<RecordedNunchuk, RecordedDAC>::linearCurve( &linear, -200, 200 );
+  pipeline.setSource( NUNCHUKDAC_CHANNEL_A, NUNCHUKDAC_JOY_X, &linear );
+  pipeline.setSource( NUNCHUKDAC_CHANNEL_B, NUNCHUKDAC_JOY_Y, &linear );
+  pipeline.begin( 2000 );
+  
+  /* One period: a request, a fetch after the acquire time, then both channels to the DAC */
+  nc.bus.clear();
+  dac.spi.clear();
+  while( !pipeline.poll() )
+    mock::advanceNanos( 5000 );
+  CHECK_EQ( nc.bus.transactions, 2 );
+  CHECK_EQ( nc.bus.log[0], NUNCHUK_TWI_DEVICE_ADDRESS << 1 );
+  CHECK_EQ( nc.bus.log[2], ( NUNCHUK_TWI_DEVICE_ADDRESS << 1 ) | 1 );
+  CHECK_EQ( dac.spi.bytes, 4 );
+  CHECK_EQ( dac.spi.select_edges, 4 );
+  CHECK( abs( (int)pipeline.getOutput( NUNCHUKDAC_CHANNEL_A ) - 4095 * 301 / 400 ) <= 2 );
+  CHECK_EQ( ( ( dac.spi.log[0] & 0x0F ) << 8 ) | dac.spi.log[1], pipeline.getOutput( NUNCHUKDAC_CHANNEL_A ) );
+  CHECK_EQ( ( ( dac.spi.log[2] & 0x0F ) << 8 ) | dac.spi.log[3], pipeline.getOutput( NUNCHUKDAC_CHANNEL_B ) );
+  CHECK_EQ( pipeline.getStats().periods, 1 );
+  
+  CHECK_EQ( mock::counters().i2c_bytes, 0 );
+  CHECK_EQ( mock::counters().spi_bytes, 0 );
+}
+
+
+int main()
+{
+  mock::reset();
+
+  test_tlv5618_mock();
+  test_write_fast_interrupts();
+  test_nunchuk_mock();
+  test_wm8731_mock();
+  test_tlv5618_soft_spi();
+  test_soft_i2c();
+  test_nunchukdac_mock();
+
+  return CHECK_RESULT();
+}
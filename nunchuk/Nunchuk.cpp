@@ -5,12 +5,16 @@
   Based on Chad Phillips' work at http://www.windmeadow.com/node/42
   and the non-OEM initialization by crimony, http://www.arduino.cc/cgi-bin/yabb2/YaBB.pl?num=1264805255
   
+  The bus side is the Nunchuk_T template in Nunchuk.h; this is the rest.
+  read() returns a status code, keeps statistics, and re-initializes the device after repeated short reads
   2012-07-30 fix a big hole in getAccel()
   2012-07-27 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
 */
 
 #include "Arduino.h"
 #include <Wire.h>
+#include <I2CBus.h>
+#include <TransportI2C.h>
 
 #include "Nunchuk.h"
 
@@ -19,93 +23,71 @@ const float radToDegrees = 57.29577951308232;
 
 // Initialization
 
-void Nunchuk::begin()
+NunchukBase::NunchukBase()
 {
-  int i;
-  
-  // Override the TWI frequency
-  //TWBR = ((CPU_FREQ / NUNCHUK_TWI_FREQ) - 16) / 2;
-  
-  Wire.begin();
-  
-  // Initialize
-  delay(1);
-  
-  Wire.beginTransmission(NUNCHUK_TWI_DEVICE_ADDRESS);	// device address
-  Wire.write(0xF0);		        // 1st initialisation register
-  Wire.write(0x55);		        // 1st initialisation value
-  Wire.endTransmission();
-  delay(1);
-  
-  Wire.beginTransmission(NUNCHUK_TWI_DEVICE_ADDRESS);
-  Wire.write(0xFB);		        // 2nd initialisation register
-  Wire.write(0x00);		        // 2nd initialisation value
-  Wire.endTransmission();
-  delay(1);
-    
-  // write the crypto key (zeros), in 3 blocks of 6, 6 & 4.
-  Wire.beginTransmission(NUNCHUK_TWI_DEVICE_ADDRESS);
-  Wire.write(0xF0);		        // crypto key command register
-  Wire.write(0xAA);		        // writes crypto enable notice
-  Wire.endTransmission();
-  delay(1);
-  
-  Wire.beginTransmission(NUNCHUK_TWI_DEVICE_ADDRESS);
-  Wire.write(0x40);		        // crypto key data address
-  for (i = 0; i < 6; i++) {
-      Wire.write(0x00);		        // writes 1st key block (zeros)
-  }
-  Wire.endTransmission();
-  delay(1);
-  
-  Wire.beginTransmission(NUNCHUK_TWI_DEVICE_ADDRESS);
-  Wire.write(0x40);		        // writes memory address
-  for (i = 6; i < 12; i++) {
-      Wire.write(0x00);		        // writes 2nd key block (zeros)
-  }
-  Wire.endTransmission();
-  delay(1);
-  
-  Wire.beginTransmission(NUNCHUK_TWI_DEVICE_ADDRESS);
-  Wire.write(0x40);		        // writes memory address
-  for (i = 12; i < 16; i++) {
-      Wire.write(0x00);		        // writes 3rd key block (zeros)
-  }
-  Wire.endTransmission();
-  delay(1);
-
-  // end device init 
+  _ok = 0;
+  _ax = _ay = _az = 0;
+  _ax2 = _ay2 = _az2 = 0;
+  memset( _buf, 0, sizeof(_buf) );
+  _backoff_ms = 0;
+  _reinit_at = 0;
+  _ready = 0;
+  resetStats();
 }
 
 
-// Read the current value
-uint8_t Nunchuk::read()
+/* After a re-initialize, give the device some time before trying again */
+bool NunchukBase::_backing_off()
+{
+  return ( _backoff_ms && (millis() - _reinit_at) < _backoff_ms );
+}
+
+/* A good read, which took t microseconds */
+void NunchukBase::_fetched( const uint8_t *raw, unsigned long t )
 {
   uint8_t i;
-  int a;
-  
-  // Request to read the new data
-  Wire.requestFrom( NUNCHUK_TWI_DEVICE_ADDRESS, NUNCHUK_TWI_BUFFER_SIZE );
-  delayMicroseconds( NUNCHUK_TWI_DELAY_MICROSEC );
   
-  // Read the new data
-  if( NUNCHUK_TWI_BUFFER_SIZE==Wire.available() )
+  _ok = 1;
+  for( i = 0; i<NUNCHUK_TWI_BUFFER_SIZE; i++ )
   {
-    _ok = 1;
-    for( i = 0; i<NUNCHUK_TWI_BUFFER_SIZE; i++ )
-    {
-      _buf[i] = _decode_byte( (uint8_t)Wire.read() );
-    }
+    _buf[i] = _decode_byte( raw[i] );
   }
+  _stats.reads_ok++;
+  _stats.consecutive_failures = 0;
+  latency_record( &_stats.latency, t );
+  _backoff_ms = 0;
+  
+  _calc_accel();
+}
+
+/* A short read.  The previous values are kept.  Returns true if it's time to re-initialize the device. */
+bool NunchukBase::_failed()
+{
+  _ok = 0;
+  _stats.reads_short++;
+  _stats.consecutive_failures++;
+  return ( (_stats.consecutive_failures % NUNCHUK_REINIT_FAILURES)==0 );
+}
+
+/* The device was just re-initialized; wait a while (longer each time) */
+void NunchukBase::_reinitialized()
+{
+  _stats.reinits++;
+  _reinit_at = millis();
+  if( _backoff_ms==0 )
+    _backoff_ms = NUNCHUK_REINIT_BACKOFF_MS;
+  else if( _backoff_ms < NUNCHUK_REINIT_BACKOFF_MAX_MS/2 )
+    _backoff_ms *= 2;
   else
-  {
-    // Throw away any more data that arrives
-    _ok = 0;
-    while( Wire.available() )
-      Wire.read();
-  }
+    _backoff_ms = NUNCHUK_REINIT_BACKOFF_MAX_MS;
+}
+
+
+/* Calculate accel and accel^2 values from the buffer */
+void NunchukBase::_calc_accel()
+{
+  int a;
   
-  // Calculate accel and accel^2 values
   a = _buf[2] * 2 * 2;
   if((_buf[5] >> 2) & 1)
     {
@@ -116,7 +98,7 @@ uint8_t Nunchuk::read()
       a += 1;
     }
   _ax = a - 511;
-  _ax2 = pow( _ax, 2 );
+  _ax2 = (long)_ax * _ax;
 
   a = _buf[3] * 2 * 2;
   if((_buf[5] >> 4) & 1)
@@ -128,7 +110,7 @@ uint8_t Nunchuk::read()
       a += 1;
     }
   _ay = a - 511;
-  _ay2 = pow( _ay, 2 );
+  _ay2 = (long)_ay * _ay;
 
   a = _buf[4] * 2 * 2;
   if((_buf[5] >> 6) & 1)
@@ -140,17 +122,26 @@ uint8_t Nunchuk::read()
       a += 1;
     }
   _az = a - 511;
-  _az2 = pow( _az, 2 );
+  _az2 = (long)_az * _az;
+}
+
 
-  // Set up the next read
-  Wire.beginTransmission( NUNCHUK_TWI_DEVICE_ADDRESS );
-  Wire.write( NUNCHUK_TWI_CMD_ZERO );
-  Wire.endTransmission( true );
+/* Statistics */
+
+uint16_t NunchukBase::getLatencyAvg()
+{
+  return latency_avg( &_stats.latency );
+}
+
+void NunchukBase::resetStats()
+{
+  memset( &_stats, 0, sizeof(_stats) );
+  latency_reset( &_stats.latency );
 }
 
 
 /* Wiimote data stream is encoded.  This decodes each byte */
-uint8_t Nunchuk::_decode_byte( uint8_t x )
+uint8_t NunchukBase::_decode_byte( uint8_t x )
 {
   x =(x ^ 0x17) + 0x17;
   return x;
@@ -159,47 +150,47 @@ uint8_t Nunchuk::_decode_byte( uint8_t x )
 
 /* Getters */
 
-bool Nunchuk::isOk()
+bool NunchukBase::isOk()
 {
   return (_ok==1);
 }
 
-bool Nunchuk::getButtonZ()
+bool NunchukBase::getButtonZ()
 {
   return !((_buf[5] >> 0) & 1);
 }
 
-bool Nunchuk::getButtonC()
+bool NunchukBase::getButtonC()
 {
   return !((_buf[5] >> 1) & 1);
 }
 
-int Nunchuk::getJoyX()
+int NunchukBase::getJoyX()
 {
   return (int)_buf[0] - 127;
 }
 
-int Nunchuk::getJoyY()
+int NunchukBase::getJoyY()
 {
   return (int)_buf[1] - 127;
 }
 
-int Nunchuk::getAccelX()
+int NunchukBase::getAccelX()
 {
   return _ax;
 }
 
-int Nunchuk::getAccelY()
+int NunchukBase::getAccelY()
 {
   return _ay;
 }
 
-int Nunchuk::getAccelZ()
+int NunchukBase::getAccelZ()
 {
   return _az;
 }
 
-float Nunchuk::getAccel()
+float NunchukBase::getAccel()
 {
   return sqrt(_ax2 + _ay2 + _az2);
 }
@@ -208,19 +199,19 @@ float Nunchuk::getAccel()
 // Tilt angles from http://www.freescale.com/files/sensors/doc/app_note/AN3461.pdf
 
 // rho
-float Nunchuk::getTiltX()
+float NunchukBase::getTiltX()
 {
   return atan(_ax/sqrt(_ay2+_az2))*radToDegrees;
 }
 
 // phi
-float Nunchuk::getTiltY()
+float NunchukBase::getTiltY()
 {
   return atan(_ay/sqrt(_ax2+_az2))*radToDegrees;
 }
 
 // theta
-float Nunchuk::getTiltZ()
+float NunchukBase::getTiltZ()
 {
   return atan(sqrt(_ay2+_ax2)/_az) *radToDegrees;
 }
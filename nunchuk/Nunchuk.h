@@ -6,7 +6,9 @@
   and the non-OEM initialization by crimony, http://www.arduino.cc/cgi-bin/yabb2/YaBB.pl?num=1264805255
   
   To use:
-  - Your sketch will need to #include <Wire.h> before you #include <Nunchuk.h>
+  - Your sketch will need to #include <Wire.h>, <I2CBus.h> and <TransportI2C.h> before you #include <Nunchuk.h>
+    The Nunchuk is a low-priority client of the shared bus, so it can share Wire with (e.g.) the WM8731.
+    For another bus, use Nunchuk_T<transport> (see TransportI2C.h), e.g. Nunchuk_T< SoftI2CTransport<2,3> >.
   - Wiring:
       - GREEN data (SDA) pin to A4 (on Teensy 2.0 this is pin 6 "D1") (Teensy 3.0 pin 18 "A4")
       - YELLOW clock (SCK) pin to A5 (on Teensy 2.0 this is pin 5 "D0") (Teensy 3.0 pin 19 "A5")
@@ -14,6 +16,22 @@
       - WHITE ground pin to arduino ground
       **NOTE** Teensy 3.0 requires pullup resistors (e.g. 10k) from the SDA and SCK pins to +3.3v.
   - Call read(), check whether it isOk(), then use the current results.
+    read() returns the data sampled at the previous read().  For fresher data,
+    call request() then fetch() a little later; read() is fetch() then request().
+  - read() returns one of the NUNCHUK_READ_xxx codes.  After a short read the previous
+    values are kept.  After NUNCHUK_REINIT_FAILURES short reads in a row the device is
+    re-initialized, and reads are then skipped for a backoff period (doubling each time).
+    If the device didn't acknowledge the re-initialize (e.g. it's unplugged), the next try after
+    the backoff is another re-initialize rather than a read; so it recovers when plugged back in.
+  - getStats() returns read counters and latency; cheap enough to log periodically.
+  
+  Cost per call (I2C bytes including address bytes; at the default 100kHz, about 0.1ms per byte):
+    read()       2 transactions, 9 bytes: fetch() 7 bytes read, request() 2 bytes write
+    begin()      7 transactions, 33 bytes (the last is a request()), plus 7ms of delay().
+                 A re-initialize from read() costs the same.
+    getAccel()   one float sqrt
+    getTiltX/Y/Z()  float sqrt and atan; prefer getAccelX/Y/Z() in fast loops
+    Nunchuk_T<MockI2CTransport> (TransportMock.h) counts the bus bytes for you (in its "bus" member).
 
   2012-07-27 @machinesalem,  (cc) https://creativecommons.org/licenses/by/3.0/
 */
@@ -22,28 +40,65 @@
 #define NUNCHUK_h
 
 #include "Arduino.h"
+#include <TransportI2C.h>
+#include <LatencyStats.h>
 
 #define NUNCHUK_TWI_DEVICE_ADDRESS 0x52
 #define NUNCHUK_TWI_CMD_IDENT      0xFA
 #define NUNCHUK_TWI_CMD_INIT       0x40
 #define NUNCHUK_TWI_CMD_ZERO       0x00
 #define NUNCHUK_TWI_BUFFER_SIZE    6
-#define NUNCHUK_TWI_DELAY_MICROSEC 10
+#define NUNCHUK_TWI_DELAY_MICROSEC 10     /* no longer used: the bus read returns when the data has arrived */
+#define NUNCHUK_MAX_HOLD_MICROSEC  1000   /* cap on one transaction on the shared bus */
+
+/* Return codes from read() */
+#define NUNCHUK_READ_OK            0    /* new data */
+#define NUNCHUK_READ_SHORT         1    /* too few bytes arrived; previous data kept */
+#define NUNCHUK_READ_REINIT        2    /* too many short reads, or not yet initialized; the device was re-initialized */
+#define NUNCHUK_READ_BACKOFF       3    /* waiting after a re-initialize; no read was attempted */
+
+/* Recovery after repeated short reads */
+#define NUNCHUK_REINIT_FAILURES       8     /* consecutive short reads before re-initializing */
+#define NUNCHUK_REINIT_BACKOFF_MS     100   /* wait after the first re-initialize */
+#define NUNCHUK_REINIT_BACKOFF_MAX_MS 3200  /* the wait doubles up to this limit */
 
 
-class Nunchuk
+/* Read statistics.  Latency is measured over successful reads only. */
+typedef struct {
+  uint32_t reads_ok;
+  uint32_t reads_short;
+  uint16_t reinits;
+  uint32_t consecutive_failures;
+  LatencyStats latency;       /* of the bus read */
+} NunchukStats;
+
+
+/* The data, calculations and statistics; Nunchuk_T adds the bus */
+class NunchukBase
 {
-  private:
+  protected:
     uint8_t _ok;
     int _ax, _ay, _az;
     long _ax2, _ay2, _az2;
     uint8_t _buf[NUNCHUK_TWI_BUFFER_SIZE];
+    NunchukStats _stats;
+    uint16_t _backoff_ms;
+    unsigned long _reinit_at;
+    uint8_t _ready;         /* the last initialize was acknowledged, and ended with a request */
+    bool _backing_off();
+    void _fetched( const uint8_t *raw, unsigned long t );
+    bool _failed();
+    void _reinitialized();
+    void _calc_accel();
     uint8_t _decode_byte(uint8_t x);
     
   public:
-    void begin();
-    uint8_t read();       /* Read the current data */
+    NunchukBase();
     bool isOk();          /* Did the data read ok? */
+    
+    const NunchukStats& getStats() { return _stats; };
+    uint16_t getLatencyAvg();   /* microseconds, average over successful reads */
+    void resetStats();
     bool getButtonZ();    /* 1 if pressed, 0 if not */
     bool getButtonC();    /* 1 if pressed, 0 if not */
     
@@ -61,4 +116,115 @@ class Nunchuk
     float getTiltZ();     /* degrees, +/- 90 */
 };
 
+
+template<class I2C_T>
+class Nunchuk_T : public NunchukBase
+{
+  private:
+    /* Device initialization sequence.  Blocks for about 7ms.
+       Ends with a request(), so the first fetch() afterwards reads a real sample, not the init registers.
+       Returns true if the device acknowledged all of it. */
+    bool _init()
+    {
+      uint8_t data[7];
+      bool ok = true;
+      
+      delay(1);
+      
+      data[0] = 0xF0;		        // 1st initialisation register
+      data[1] = 0x55;		        // 1st initialisation value
+      ok = ( I2CBUS_OK==bus.write( NUNCHUK_TWI_DEVICE_ADDRESS, data, 2 ) ) && ok;
+      delay(1);
+      
+      data[0] = 0xFB;		        // 2nd initialisation register
+      data[1] = 0x00;		        // 2nd initialisation value
+      ok = ( I2CBUS_OK==bus.write( NUNCHUK_TWI_DEVICE_ADDRESS, data, 2 ) ) && ok;
+      delay(1);
+        
+      // write the crypto key (zeros), in 3 blocks of 6, 6 & 4.
+      data[0] = 0xF0;		        // crypto key command register
+      data[1] = 0xAA;		        // writes crypto enable notice
+      ok = ( I2CBUS_OK==bus.write( NUNCHUK_TWI_DEVICE_ADDRESS, data, 2 ) ) && ok;
+      delay(1);
+      
+      memset( data, 0, sizeof(data) );
+      data[0] = 0x40;		        // crypto key data address
+      ok = ( I2CBUS_OK==bus.write( NUNCHUK_TWI_DEVICE_ADDRESS, data, 7 ) ) && ok;    // 1st key block (zeros)
+      delay(1);
+      
+      ok = ( I2CBUS_OK==bus.write( NUNCHUK_TWI_DEVICE_ADDRESS, data, 7 ) ) && ok;    // 2nd key block (zeros)
+      delay(1);
+      
+      ok = ( I2CBUS_OK==bus.write( NUNCHUK_TWI_DEVICE_ADDRESS, data, 5 ) ) && ok;    // 3rd key block (zeros)
+      delay(1);
+    
+      // end device init 
+      return ok && request();
+    };
+    
+    /* Initialize again, and back off for a while.  Returns NUNCHUK_READ_REINIT */
+    uint8_t _restart()
+    {
+      _ready = _init();
+      _reinitialized();
+      return NUNCHUK_READ_REINIT;
+    };
+    
+  public:
+    I2C_T bus;            /* the transport */
+    
+    void begin()
+    {
+      // Override the TWI frequency
+      //TWBR = ((CPU_FREQ / NUNCHUK_TWI_FREQ) - 16) / 2;
+      
+      bus.begin( I2CBUS_PRIORITY_LOW, NUNCHUK_MAX_HOLD_MICROSEC );
+      _ready = _init();
+    };
+    
+    /* Read the current data, and ask for the next.  Returns NUNCHUK_READ_xxx */
+    uint8_t read()
+    {
+      uint8_t rc = fetch();
+      
+      if( rc==NUNCHUK_READ_OK || rc==NUNCHUK_READ_SHORT )
+        request();
+      return rc;
+    };
+    
+    /* Ask the device to sample new data.  Returns false if it wasn't acknowledged. */
+    bool request()
+    {
+      uint8_t cmd = NUNCHUK_TWI_CMD_ZERO;
+      return ( I2CBUS_OK==bus.write( NUNCHUK_TWI_DEVICE_ADDRESS, &cmd, 1 ) );
+    };
+    
+    /* Read the data sampled at request().  Returns NUNCHUK_READ_xxx */
+    uint8_t fetch()
+    {
+      uint8_t raw[NUNCHUK_TWI_BUFFER_SIZE];
+      unsigned long t;
+      
+      if( _backing_off() )
+        return NUNCHUK_READ_BACKOFF;
+      if( !_ready )
+        return _restart();    // not initialized yet; reading would only get the init registers
+      
+      // Read the new data
+      t = micros();
+      if( I2CBUS_OK==bus.read( NUNCHUK_TWI_DEVICE_ADDRESS, raw, NUNCHUK_TWI_BUFFER_SIZE ) )
+      {
+        _fetched( raw, micros() - t );
+        return NUNCHUK_READ_OK;
+      }
+      
+      if( _failed() )
+        return _restart();    // probably unplugged or confused; start it again
+      return NUNCHUK_READ_SHORT;
+    };
+};
+
+/* The Nunchuk on the shared Wire bus */
+typedef Nunchuk_T<SharedWireTransport> Nunchuk;
+
 #endif